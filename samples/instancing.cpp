@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <memory>
+
+#include <broom/application.hpp>
+#include <broom/buffer.hpp>
+#include <broom/draw.hpp>
+#include <broom/program.hpp>
+#include <broom/shader.hpp>
+#include <broom/texture.hpp>
+#include <broom/vertex_array.hpp>
+
+using namespace broom;
+
+struct Vertex {
+  glm::vec2 pos;
+  glm::vec2 tex_coord;
+};
+
+struct Instance {
+  glm::vec2 offset;
+  float scale;
+  glm::vec4 color;
+};
+
+using QuadLayout = VertexLayout<VertexAttribute<0, &Vertex::pos>, VertexAttribute<1, &Vertex::tex_coord>>;
+using InstanceLayout = VertexLayout<VertexAttribute<2, &Instance::offset>,
+                                    VertexAttribute<3, &Instance::scale>,
+                                    VertexAttribute<4, &Instance::color>>;
+
+class InstancingApp : public Application {
+ public:
+  static constexpr unsigned int columns = 400;
+  static constexpr unsigned int rows = 250;
+
+  InstancingApp() : Application{"instancing"} {}
+  InstancingApp(const glm::uvec2& headless_resolution) : Application{"instancing", headless_resolution} {}
+
+  bool init() override {
+    if (!Application::init()) {
+      return false;
+    }
+    _program = std::make_unique<Program, std::initializer_list<Shader>>(
+        {Shader::load_from_file("shaders/instanced_texture.vert"),
+         Shader::load_from_file("shaders/colored_texture.frag")});
+
+    _vbo = std::make_unique<Buffer>();
+    _vbo->set_data(std::vector<Vertex>{{glm::vec2{-0.5, -0.5}, glm::vec2{0.0f, 0.0f}},
+                                       {glm::vec2{0.5, -0.5}, glm::vec2{1.0f, 0.0f}},
+                                       {glm::vec2{-0.5, 0.5}, glm::vec2{0.0f, 1.0f}},
+                                       {glm::vec2{0.5, 0.5}, glm::vec2{1.0f, 1.0f}}});
+
+    _ibo = std::make_unique<Buffer>();
+    _ibo->set_data(std::vector<uint32_t>{0, 1, 2, 2, 1, 3});
+
+    // one quad per cell of a grid covering the whole viewport
+    std::vector<Instance> instances;
+    instances.reserve(columns * rows);
+    glm::vec2 cell{2.0f / columns, 2.0f / rows};
+    for (unsigned int y = 0; y < rows; ++y) {
+      for (unsigned int x = 0; x < columns; ++x) {
+        glm::vec2 offset = glm::vec2{-1.0f, -1.0f} + cell * glm::vec2{x + 0.5f, y + 0.5f};
+        glm::vec4 color{static_cast<float>(x) / columns, static_cast<float>(y) / rows, 0.5f, 1.0f};
+        instances.push_back(Instance{offset, 0.9f * std::min(cell.x, cell.y), color});
+      }
+    }
+    _instances = std::make_unique<Buffer>();
+    _instances->set_data(instances);
+
+    _vao = std::make_unique<VertexArray>();
+    _vao->set_element_buffer(*_ibo);
+
+    // binding 0 advances per vertex, binding 1 per instance
+    _vao->set_vertex_buffer(0, *_vbo, QuadLayout::format());
+    _vao->set_vertex_buffer(1, *_instances, InstanceLayout::format(), 0, 1);
+
+    _texture = std::make_unique<Texture>();
+    _texture->load_image_from_file("images/heart.png");
+    _texture->set_mag_filter(GL_NEAREST);
+
+    return true;
+  }
+
+  void draw() const override {
+    Application::draw();
+    _program->use();
+    _texture->bind();
+    _vao->bind();
+    draw_elements_instanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, columns * rows);
+  }
+
+ protected:
+  std::unique_ptr<Program> _program;
+  std::unique_ptr<Buffer> _vbo;
+  std::unique_ptr<Buffer> _ibo;
+  std::unique_ptr<Buffer> _instances;
+  std::unique_ptr<VertexArray> _vao;
+  std::unique_ptr<Texture> _texture;
+};
+
+int main(int argc, char const* argv[]) {
+  if (argc > 1) {
+    // render the given number of frames offscreen, e.g. `instancing 1000`
+    auto app = std::make_shared<InstancingApp>(glm::uvec2{1280, 720});
+    app->run(std::stoul(argv[1]));
+    return EXIT_SUCCESS;
+  }
+  auto app = std::make_shared<InstancingApp>();
+  app->run();
+  return EXIT_SUCCESS;
+}
@@ -13,9 +13,12 @@ struct Vertex {
   glm::vec4 color;
 };
 
+using TriangleLayout = VertexLayout<VertexAttribute<0, &Vertex::pos>, VertexAttribute<1, &Vertex::color>>;
+
 class TriangleApp : public Application {
  public:
   TriangleApp() : Application{"triangle"} {}
+  TriangleApp(const glm::uvec2& headless_resolution) : Application{"triangle", headless_resolution} {}
 
   bool init() override {
     if (!Application::init()) {
@@ -33,13 +36,7 @@ class TriangleApp : public Application {
     });
 
     _vao = std::make_unique<VertexArray>();
-    _vao->set_vertex_buffer(0, *_vbo, 0, sizeof(Vertex));
-    _vao->set_attribute_enabled(0, true);
-    _vao->set_attribute_enabled(1, true);
-    _vao->set_attribute_format(0, 2, GL_FLOAT, false, offsetof(Vertex, pos));
-    _vao->set_attribute_format(1, 4, GL_FLOAT, false, offsetof(Vertex, color));
-    _vao->set_attribute_binding(0, 0);
-    _vao->set_attribute_binding(1, 0);
+    _vao->set_vertex_buffer(0, *_vbo, TriangleLayout::format());
 
     return true;
   }
@@ -58,6 +55,12 @@ class TriangleApp : public Application {
 };
 
 int main(int argc, char const* argv[]) {
+  if (argc > 1) {
+    // render the given number of frames offscreen, e.g. `triangle 1000`
+    auto app = std::make_shared<TriangleApp>(glm::uvec2{1280, 720});
+    app->run(std::stoul(argv[1]));
+    return EXIT_SUCCESS;
+  }
   auto app = std::make_shared<TriangleApp>();
   app->run();
   return EXIT_SUCCESS;
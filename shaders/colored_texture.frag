@@ -1,7 +1,7 @@
 #version 450 core
 
-in vec2 v_tex_coord;
-in vec4 v_color;
+layout(location = 0) in vec2 v_tex_coord;
+layout(location = 1) in vec4 v_color;
 out vec4 out_color;
 
 uniform sampler2D tex;
@@ -0,0 +1,20 @@
+#version 450 core
+
+layout(location = 0) in vec2 in_pos;
+layout(location = 1) in vec2 in_tex_coord;
+
+// per instance
+layout(location = 2) in vec2 in_offset;
+layout(location = 3) in float in_scale;
+layout(location = 4) in vec4 in_color;
+
+layout(location = 0) out vec2 v_tex_coord;
+layout(location = 1) out vec4 v_color;
+
+void main() {
+  gl_Position = vec4(in_pos * in_scale + in_offset, 0.0, 1.0);
+
+  // pass-through
+  v_tex_coord = in_tex_coord;
+  v_color = in_color;
+}
@@ -1,6 +1,6 @@
 #version 450 core
 
-in vec4 v_color;
+layout(location = 0) in vec4 v_color;
 
 out vec4 out_color;
 
@@ -2,8 +2,12 @@
 
 namespace broom {
 
-Application::Application(const std::string& name)
-    : _name{name}, _clear_color{0.14901961, 0.19607843, 0.21960784, 0.00392157} {
+Application::Application(const std::string& name) : Application{name, glm::uvec2{0, 0}} {}
+
+Application::Application(const std::string& name, const glm::uvec2& headless_resolution)
+    : _name{name},
+      _headless_resolution{headless_resolution},
+      _clear_color{0.14901961, 0.19607843, 0.21960784, 0.00392157} {
 #ifdef NDEBUG
   spdlog::set_level(spdlog::level::info);
 #else
@@ -12,18 +16,27 @@ Application::Application(const std::string& name)
 }
 
 Application::~Application() {
+  _frame_timer.destroy();
   _window = nullptr;
+  _headless = nullptr;
   glfwTerminate();
 }
 
 bool Application::init() {
-  if (!init_glfw()) {
-    return false;
+  if (headless()) {
+    if (!init_headless()) {
+      return false;
+    }
+  } else {
+    if (!init_glfw()) {
+      return false;
+    }
+    _window = std::make_unique<Window>(shared_from_this(), _name);
   }
-  _window = std::make_unique<Window>(shared_from_this(), _name);
   if (!init_opengl()) {
     return false;
   }
+  _frame_timer.init();
   spdlog::debug("Initialized application \"{}\"", _name);
   return true;
 }
@@ -36,6 +49,25 @@ const glm::vec4 Application::clear_color() const {
   return _clear_color;
 }
 
+bool Application::headless() const {
+  return _headless_resolution.x > 0 && _headless_resolution.y > 0;
+}
+
+glm::uvec2 Application::resolution() const {
+  if (_headless) {
+    return _headless->resolution();
+  }
+  return _window->resolution();
+}
+
+bool Application::should_close() const {
+  return _window && _window->should_close();
+}
+
+const FrameTimer& Application::frame_timer() const {
+  return _frame_timer;
+}
+
 void Application::set_clear_color(const glm::vec4& color) {
   _clear_color = color;
 }
@@ -58,19 +90,35 @@ void Application::run() {
   if (!init()) {
     throw std::runtime_error("Failed to initialize application \"" + _name + "\"");
   }
-  while (!_window->should_close()) {
-    draw();
-    _window->swap_buffers();
-    update();
+  while (!should_close()) {
+    render_frame();
+  }
+}
+
+void Application::run(unsigned int frames) {
+  if (!init()) {
+    throw std::runtime_error("Failed to initialize application \"" + _name + "\"");
+  }
+  for (unsigned int frame = 0; frame < frames && !should_close(); ++frame) {
+    render_frame();
   }
+  // wait for the last frames so that the whole budget is accounted for when the caller measures time
+  glFinish();
+  _frame_timer.collect_pending();
+  spdlog::info("Application \"{}\" finished after {} frames", _name, _frame_timer.frame_count());
+  _frame_timer.log_statistics();
+  auto counters = StateCache::current().counters();
+  spdlog::info("State changes: {} issued, {} skipped", counters.issued, counters.skipped);
 }
 
 void Application::update() {
-  glfwPollEvents();
+  if (_window) {
+    glfwPollEvents();
+  }
 }
 
 void Application::draw() const {
-  glViewport(0, 0, _window->resolution().x, _window->resolution().y);
+  glViewport(0, 0, resolution().x, resolution().y);
   glClearColor(_clear_color.r, _clear_color.g, _clear_color.b, _clear_color.a);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -96,8 +144,20 @@ bool Application::init_glfw() const {
   return true;
 }
 
+bool Application::init_headless() {
+  try {
+    _headless = std::make_unique<HeadlessContext>(_name, _headless_resolution);
+  } catch (const std::runtime_error& error) {
+    spdlog::error("Failed to create headless context: {}", error.what());
+    return false;
+  }
+  spdlog::debug("Initialized headless context");
+  return true;
+}
+
 bool Application::init_opengl() const {
-  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+  auto loader = _headless ? (GLADloadproc)HeadlessContext::get_proc_address : (GLADloadproc)glfwGetProcAddress;
+  if (!gladLoadGLLoader(loader)) {
     spdlog::error("Failed to initialize OpenGL");
     return false;
   }
@@ -108,10 +168,41 @@ bool Application::init_opengl() const {
   glDebugMessageCallback(debug_message_callback, 0);
 #endif
 
+  if (_headless) {
+    _headless->create_framebuffer();
+  }
+
+  // a fresh context starts with default state, not with whatever the cache saw last
+  StateCache::current().set_defaults();
+
   spdlog::debug("Initialized OpenGL");
   return true;
 }
 
+void Application::render_frame() {
+  _frame_timer.begin_frame();
+
+  _frame_timer.begin(TimerScope::cpu_draw);
+  _frame_timer.begin(TimerScope::gpu_draw);
+  draw();
+  _frame_timer.end(TimerScope::gpu_draw);
+  _frame_timer.end(TimerScope::cpu_draw);
+
+  _frame_timer.begin(TimerScope::cpu_swap);
+  if (_headless) {
+    _headless->swap_buffers();
+  } else {
+    _window->swap_buffers();
+  }
+  _frame_timer.end(TimerScope::cpu_swap);
+
+  _frame_timer.begin(TimerScope::cpu_update);
+  update();
+  _frame_timer.end(TimerScope::cpu_update);
+
+  _frame_timer.end_frame();
+}
+
 void GLAPIENTRY debug_message_callback(GLenum source,
                                        GLenum type,
                                        GLuint id,
@@ -178,7 +269,9 @@ void GLAPIENTRY debug_message_callback(GLenum source,
 
   spdlog::log(level, "OpenGL debug message [{}, {}]: {}", source_str, type_str, message);
 
-  if (type == GL_DEBUG_TYPE_ERROR) {
+  // compile and link errors are reported through the shader and program status, e.g. to keep running
+  // with the previous program when a reloaded shader is broken
+  if (type == GL_DEBUG_TYPE_ERROR && source != GL_DEBUG_SOURCE_SHADER_COMPILER) {
     throw std::runtime_error("OpenGL Error: " + std::string(message));
   }
 }
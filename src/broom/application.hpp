@@ -5,7 +5,10 @@
 
 #include <spdlog/spdlog.h>
 
+#include <broom/frame_timer.hpp>
+#include <broom/headless_context.hpp>
 #include <broom/opengl.hpp>
+#include <broom/state_cache.hpp>
 #include <broom/window.hpp>
 
 namespace broom {
@@ -13,6 +16,7 @@ namespace broom {
 class Application : public std::enable_shared_from_this<Application> {
  public:
   Application(const std::string& name);
+  Application(const std::string& name, const glm::uvec2& headless_resolution);
   Application(const Application&) = delete;
   Application(Application&&) = default;
   virtual ~Application();
@@ -24,6 +28,10 @@ class Application : public std::enable_shared_from_this<Application> {
 
   const std::string& name() const;
   const glm::vec4 clear_color() const;
+  bool headless() const;
+  glm::uvec2 resolution() const;
+  bool should_close() const;
+  const FrameTimer& frame_timer() const;
 
   void set_clear_color(const glm::vec4& color);
 
@@ -34,17 +42,23 @@ class Application : public std::enable_shared_from_this<Application> {
   virtual void on_scroll(Window& window, double x, double y);
 
   virtual void run();
+  virtual void run(unsigned int frames);
   virtual void update();
   virtual void draw() const;
 
  protected:
   bool init_glfw() const;
+  bool init_headless();
   bool init_opengl() const;
+  void render_frame();
 
  protected:
   std::string _name;
+  glm::uvec2 _headless_resolution;
   std::unique_ptr<Window> _window;
+  std::unique_ptr<HeadlessContext> _headless;
   glm::vec4 _clear_color;
+  FrameTimer _frame_timer;
 };
 
 void GLAPIENTRY debug_message_callback(GLenum source,
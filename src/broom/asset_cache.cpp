@@ -0,0 +1,98 @@
+#include <broom/asset_cache.hpp>
+
+namespace broom {
+
+AssetCache::AssetCache(std::size_t memory_budget)
+    : _memory_budget{memory_budget}, _memory_usage{0}, _statistics{0, 0, 0} {}
+
+std::shared_ptr<Texture> AssetCache::texture(const std::string& filename, bool mipmaps, bool srgb) {
+  auto key = "texture:" + filename + (mipmaps ? ":mipmaps" : "") + (srgb ? "" : ":linear");
+  return find_or_load<Texture>(key, [&](std::size_t& memory) {
+    auto texture = std::make_shared<Texture>(Texture::load_from_file(filename, mipmaps, srgb));
+    memory = texture->memory_size();
+    return texture;
+  });
+}
+
+std::shared_ptr<Shader> AssetCache::shader(const std::string& filename, GLenum type) {
+  auto key = "shader:" + filename + ":" + std::to_string(type);
+  return find_or_load<Shader>(key, [&](std::size_t&) {
+    return std::make_shared<Shader>(Shader::load_from_file(filename, type));
+  });
+}
+
+std::shared_ptr<Program> AssetCache::program(const std::vector<std::string>& shader_filenames) {
+  std::string key = "program";
+  for (const auto& filename : shader_filenames) {
+    key += ":" + filename;
+  }
+  return find_or_load<Program>(key, [&](std::size_t&) {
+    std::set<Shader> shaders;
+    for (const auto& filename : shader_filenames) {
+      shaders.insert(*shader(filename));
+    }
+    auto program = std::make_shared<Program>(shaders);
+    if (!program->link_status()) {
+      throw std::runtime_error("Failed to link program \"" + key + "\"");
+    }
+    return program;
+  });
+}
+
+std::size_t AssetCache::size() const {
+  return _entries.size();
+}
+
+std::size_t AssetCache::memory_usage() const {
+  return _memory_usage;
+}
+
+std::size_t AssetCache::memory_budget() const {
+  return _memory_budget;
+}
+
+void AssetCache::set_memory_budget(std::size_t budget) {
+  _memory_budget = budget;
+  trim();
+}
+
+const AssetStatistics& AssetCache::statistics() const {
+  return _statistics;
+}
+
+void AssetCache::reset_statistics() {
+  _statistics = AssetStatistics{0, 0, 0};
+}
+
+void AssetCache::log_statistics() const {
+  spdlog::info("Asset cache: {} entries, {:.1f} of {:.1f} MiB, {} hits, {} misses ({:.1f}% hit rate), {} evictions",
+               _entries.size(), _memory_usage / (1024.0 * 1024.0), _memory_budget / (1024.0 * 1024.0),
+               _statistics.hits, _statistics.misses, 100.0 * _statistics.hit_rate(), _statistics.evictions);
+}
+
+void AssetCache::trim() {
+  // oldest first, skipping entries that free nothing or are held outside of the cache
+  for (auto key = _recency.end(); _memory_usage > _memory_budget && key != _recency.begin();) {
+    --key;
+    auto entry = _entries.find(*key);
+    if (entry->second.memory == 0 || entry->second.asset.use_count() > 1) {
+      continue;
+    }
+    spdlog::debug("Evicting {} from the asset cache", *key);
+    _memory_usage -= entry->second.memory;
+    ++_statistics.evictions;
+    _entries.erase(entry);
+    key = _recency.erase(key);
+  }
+  if (_memory_usage > _memory_budget) {
+    spdlog::debug("Assets in use need {} bytes, more than the budget of {}", _memory_usage, _memory_budget);
+  }
+}
+
+void AssetCache::clear() {
+  _entries.clear();
+  _recency.clear();
+  _memory_usage = 0;
+}
+
+}  // namespace broom
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+#include <broom/program.hpp>
+#include <broom/shader.hpp>
+#include <broom/texture.hpp>
+
+namespace broom {
+
+struct AssetStatistics {
+  std::size_t hits;
+  std::size_t misses;
+  std::size_t evictions;
+
+  double hit_rate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+// Loads textures, shaders and programs once per path and parameters and hands out shared handles to them.
+//
+// When the GPU memory of the cached textures exceeds the budget, textures nobody else holds a handle to
+// are evicted, least recently used first. Assets still in use are never evicted and stay valid as long as
+// their handles live. Shaders and programs are small and stay cached until clear().
+class AssetCache {
+ public:
+  AssetCache(std::size_t memory_budget = 512 * 1024 * 1024);
+  AssetCache(const AssetCache&) = delete;
+  AssetCache(AssetCache&&) = delete;
+
+  AssetCache& operator=(const AssetCache& other) = delete;
+  AssetCache& operator=(AssetCache&& other) = delete;
+
+  // pass srgb = false for masks, normals and heights so that their mipmaps are filtered linearly
+  std::shared_ptr<Texture> texture(const std::string& filename, bool mipmaps = false, bool srgb = true);
+  std::shared_ptr<Shader> shader(const std::string& filename, GLenum type = GL_NONE);
+  // shaders are shared with other programs through the cache, types are detected from the filenames
+  std::shared_ptr<Program> program(const std::vector<std::string>& shader_filenames);
+
+  std::size_t size() const;
+  std::size_t memory_usage() const;
+  std::size_t memory_budget() const;
+  void set_memory_budget(std::size_t budget);
+  const AssetStatistics& statistics() const;
+  void reset_statistics();
+  void log_statistics() const;
+
+  // evicts unused entries until the budget is met, done after every load
+  void trim();
+  // drops every entry, handles held elsewhere stay valid
+  void clear();
+
+ protected:
+  struct Entry {
+    std::shared_ptr<void> asset;
+    std::size_t memory;
+    std::list<std::string>::iterator recency;
+  };
+
+  template <typename T, typename Load>
+  std::shared_ptr<T> find_or_load(const std::string& key, Load&& load) {
+    auto entry = _entries.find(key);
+    if (entry != _entries.end()) {
+      ++_statistics.hits;
+      _recency.splice(_recency.begin(), _recency, entry->second.recency);
+      return std::static_pointer_cast<T>(entry->second.asset);
+    }
+
+    ++_statistics.misses;
+    std::size_t memory = 0;
+    std::shared_ptr<T> asset = load(memory);
+    _recency.push_front(key);
+    _entries.emplace(key, Entry{asset, memory, _recency.begin()});
+    _memory_usage += memory;
+    trim();
+    return asset;
+  }
+
+ protected:
+  std::size_t _memory_budget;
+  std::size_t _memory_usage;
+  AssetStatistics _statistics;
+  std::unordered_map<std::string, Entry> _entries;
+  // most recently used first
+  std::list<std::string> _recency;
+};
+
+}  // namespace broom
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include <broom/opengl.hpp>
+#include <broom/uniform.hpp>
+
+namespace broom {
+
+enum class BlockPacking { std140, std430 };
+
+// Alignment and size of a member type under std140 or std430 rules, the size includes array and matrix
+// column padding so that it has to match the C++ type's size.
+template <BlockPacking P, typename T, typename = void>
+struct BlockMember;
+
+template <BlockPacking P, typename T>
+struct BlockMember<P, T, std::enable_if_t<is_uniform_component<T>>> {
+  static constexpr std::size_t alignment = sizeof(T);
+  static constexpr std::size_t size = sizeof(T);
+};
+
+template <BlockPacking P, glm::length_t L, typename T, glm::qualifier Q>
+struct BlockMember<P, glm::vec<L, T, Q>> {
+  static_assert(is_uniform_component<T>, "Block vectors hold GLint, GLuint, GLfloat or GLdouble");
+  // three component vectors are aligned like four component ones
+  static constexpr std::size_t alignment = (L == 1 ? 1 : L == 2 ? 2 : 4) * sizeof(T);
+  static constexpr std::size_t size = L * sizeof(T);
+};
+
+// arrays and matrix columns, std140 rounds the stride up to a multiple of 16 bytes
+template <BlockPacking P, typename T>
+struct BlockArrayElement {
+  static constexpr std::size_t alignment = P == BlockPacking::std140 && BlockMember<P, T>::alignment < 16
+                                               ? 16
+                                               : BlockMember<P, T>::alignment;
+  static constexpr std::size_t stride = (BlockMember<P, T>::size + alignment - 1) / alignment * alignment;
+};
+
+template <BlockPacking P, glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+struct BlockMember<P, glm::mat<C, R, T, Q>> {
+  static_assert(std::is_same_v<T, GLfloat> || std::is_same_v<T, GLdouble>, "Block matrices hold floats or doubles");
+  static constexpr std::size_t alignment = BlockArrayElement<P, glm::vec<R, T, Q>>::alignment;
+  static constexpr std::size_t size = C * BlockArrayElement<P, glm::vec<R, T, Q>>::stride;
+};
+
+template <BlockPacking P, typename T, std::size_t N>
+struct BlockMember<P, T[N]> {
+  static constexpr std::size_t alignment = BlockArrayElement<P, T>::alignment;
+  static constexpr std::size_t size = N * BlockArrayElement<P, T>::stride;
+};
+
+template <BlockPacking P, typename T, std::size_t N>
+struct BlockMember<P, std::array<T, N>> : BlockMember<P, T[N]> {};
+
+// The offsets and size GLSL gives a block with the member types in declaration order, to check the C++
+// struct mirroring the block at compile time:
+//
+//   struct Camera { glm::mat4 view; glm::vec3 position; float exposure; };
+//   static_assert(BlockLayout<BlockPacking::std140, glm::mat4, glm::vec3, float>::matches<Camera>(
+//       {offsetof(Camera, view), offsetof(Camera, position), offsetof(Camera, exposure)}));
+//
+// Members whose C++ size differs from their padded GLSL size, e.g. glm::mat3 or float[4] under std140,
+// make the check fail as well.
+template <BlockPacking P, typename... Members>
+struct BlockLayout {
+  static constexpr std::size_t count = sizeof...(Members);
+  static constexpr std::array<std::size_t, count> alignments = {BlockMember<P, Members>::alignment...};
+  static constexpr std::array<std::size_t, count> sizes = {BlockMember<P, Members>::size...};
+  static constexpr std::array<bool, count> sizes_match = {(sizeof(Members) == BlockMember<P, Members>::size)...};
+
+  static constexpr std::size_t alignment() {
+    std::size_t result = P == BlockPacking::std140 ? 16 : 1;
+    for (auto member : alignments) {
+      result = member > result ? member : result;
+    }
+    return result;
+  }
+
+  static constexpr std::array<std::size_t, count> offsets() {
+    std::array<std::size_t, count> result{};
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      offset = (offset + alignments[i] - 1) / alignments[i] * alignments[i];
+      result[i] = offset;
+      offset += sizes[i];
+    }
+    return result;
+  }
+
+  // including the padding at the end, as reported by GL_BUFFER_DATA_SIZE
+  static constexpr std::size_t size() {
+    std::size_t end = count > 0 ? offsets()[count - 1] + sizes[count - 1] : 0;
+    return (end + alignment() - 1) / alignment() * alignment();
+  }
+
+  template <typename Block>
+  static constexpr bool matches(const std::array<std::size_t, count>& member_offsets) {
+    static_assert(std::is_standard_layout_v<Block>, "Blocks need a standard layout for offsetof");
+    auto expected = offsets();
+    for (std::size_t i = 0; i < count; ++i) {
+      if (member_offsets[i] != expected[i] || !sizes_match[i]) {
+        return false;
+      }
+    }
+    return sizeof(Block) == size();
+  }
+};
+
+template <typename... Members>
+using Std140Layout = BlockLayout<BlockPacking::std140, Members...>;
+template <typename... Members>
+using Std430Layout = BlockLayout<BlockPacking::std430, Members...>;
+
+}  // namespace broom
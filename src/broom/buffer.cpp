@@ -30,18 +30,62 @@ GLenum Buffer::usage() const {
   return get_parameter(GL_BUFFER_USAGE);
 }
 
+bool Buffer::immutable() const {
+  return get_parameter(GL_BUFFER_IMMUTABLE_STORAGE) != GL_FALSE;
+}
+
+GLbitfield Buffer::storage_flags() const {
+  return get_parameter(GL_BUFFER_STORAGE_FLAGS);
+}
+
+bool Buffer::mapped() const {
+  return get_parameter(GL_BUFFER_MAPPED) != GL_FALSE;
+}
+
 void Buffer::bind(GLenum target) const {
-  glBindBuffer(target, _id);
+  StateCache::current().bind_buffer(target, _id);
 }
 
 void Buffer::unbind(GLenum target) {
-  glBindBuffer(target, 0);
+  StateCache::current().bind_buffer(target, 0);
+}
+
+void Buffer::bind_range(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) const {
+  StateCache::current().bind_buffer_range(target, index, _id, offset, size);
+}
+
+void Buffer::bind_base(GLenum target, GLuint index) const {
+  bind_range(target, index, 0, size());
 }
 
 void Buffer::set_data(GLsizeiptr size, const void* data, GLenum usage) {
   glNamedBufferData(_id, size, data, usage);
 }
 
+void Buffer::set_storage(GLsizeiptr size, const void* data, GLbitfield flags) {
+  glNamedBufferStorage(_id, size, data, flags);
+}
+
+void Buffer::flush_mapped_range(GLintptr offset, GLsizeiptr size) const {
+  glFlushMappedNamedBufferRange(_id, offset, size);
+}
+
+bool Buffer::unmap() const {
+  return glUnmapNamedBuffer(_id) != GL_FALSE;
+}
+
+void Buffer::invalidate_data() {
+  glInvalidateBufferData(_id);
+}
+
+void Buffer::invalidate_sub_data(GLintptr offset, GLsizeiptr size) {
+  glInvalidateBufferSubData(_id, offset, size);
+}
+
+void Buffer::copy_sub_data(const Buffer& source, GLintptr source_offset, GLintptr offset, GLsizeiptr size) {
+  glCopyNamedBufferSubData(source._id, _id, source_offset, offset, size);
+}
+
 void Buffer::set_sub_data(GLintptr offset, GLsizeiptr size, const void* data) {
   glNamedBufferSubData(_id, offset, size, data);
 }
@@ -59,6 +103,15 @@ void Buffer::clear_data(GLenum internal_format, GLenum format, GLenum data_type,
   glClearNamedBufferData(_id, internal_format, format, data_type, data);
 }
 
+void* Buffer::map_range_raw(GLintptr offset, GLsizeiptr size, GLbitfield access) {
+  auto data = glMapNamedBufferRange(_id, offset, size, access);
+  if (nullptr == data) {
+    spdlog::error("Failed to map {} bytes at offset {} of buffer {}", size, offset, _id);
+    throw std::runtime_error("Failed to map buffer range!");
+  }
+  return data;
+}
+
 GLint Buffer::get_parameter(GLenum parameter) const {
   GLint result;
   glGetNamedBufferParameteriv(_id, parameter, &result);
@@ -67,6 +120,7 @@ GLint Buffer::get_parameter(GLenum parameter) const {
 
 void Buffer::destroy() const {
   if (valid()) {
+    StateCache::current().forget_buffer(_id);
     glDeleteBuffers(1, &_id);
   }
 }
@@ -1,13 +1,72 @@
 #pragma once
 
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
 #include <broom/opengl.hpp>
+#include <broom/span.hpp>
+#include <broom/state_cache.hpp>
 
 namespace broom {
 
+// A typed view of a mapped buffer range that unmaps the buffer when it goes out of scope.
+template <typename T>
+class BufferMapping : public Span<T> {
+ public:
+  BufferMapping() : Span<T>{}, _buffer{0}, _offset{0} {}
+  BufferMapping(GLuint buffer, GLintptr offset, T* data, std::size_t count)
+      : Span<T>{data, count}, _buffer{buffer}, _offset{offset} {}
+  BufferMapping(const BufferMapping&) = delete;
+  BufferMapping(BufferMapping&& other) : Span<T>{other}, _buffer{other._buffer}, _offset{other._offset} {
+    other.release();
+  }
+  ~BufferMapping() { unmap(); }
+
+  BufferMapping& operator=(const BufferMapping& other) = delete;
+  BufferMapping& operator=(BufferMapping&& other) {
+    if (this != &other) {
+      unmap();
+      Span<T>::operator=(other);
+      _buffer = other._buffer;
+      _offset = other._offset;
+      other.release();
+    }
+    return *this;
+  }
+
+  bool mapped() const { return this->_data != nullptr; }
+  // byte offset of the mapping within the buffer
+  GLintptr offset() const { return _offset; }
+
+  // only for mappings with GL_MAP_FLUSH_EXPLICIT_BIT, first and count are elements of this mapping
+  void flush(std::size_t first, std::size_t count) const {
+    glFlushMappedNamedBufferRange(_buffer, first * sizeof(T), count * sizeof(T));
+  }
+  void flush() const { flush(0, this->_size); }
+
+  void unmap() {
+    if (mapped()) {
+      if (glUnmapNamedBuffer(_buffer) == GL_FALSE) {
+        spdlog::warn("Contents of buffer {} became corrupt while it was mapped", _buffer);
+      }
+      release();
+    }
+  }
+
+ protected:
+  void release() {
+    this->_data = nullptr;
+    this->_size = 0;
+  }
+
+ protected:
+  GLuint _buffer;
+  GLintptr _offset;
+};
+
 class Buffer {
  public:
   Buffer();
@@ -24,15 +83,41 @@ class Buffer {
   GLuint id() const;
   GLsizeiptr size() const;
   GLenum usage() const;
+  bool immutable() const;
+  GLbitfield storage_flags() const;
+  bool mapped() const;
 
   void bind(GLenum target) const;
   static void unbind(GLenum target);
+  void bind_range(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) const;
+  void bind_base(GLenum target, GLuint index) const;
 
   template <typename T>
   void set_data(const std::vector<T>& vector, GLenum usage = GL_STATIC_DRAW) {
     set_data(sizeof(T) * vector.size(), vector.data(), usage);
   }
   void set_data(GLsizeiptr size, const void* data = nullptr, GLenum usage = GL_STATIC_DRAW);
+
+  // immutable storage, the size can not change afterwards and flags decide how the buffer may be accessed
+  template <typename T>
+  void set_storage(const std::vector<T>& vector, GLbitfield flags = 0) {
+    set_storage(sizeof(T) * vector.size(), vector.data(), flags);
+  }
+  void set_storage(GLsizeiptr size, const void* data = nullptr, GLbitfield flags = 0);
+
+  // offset in bytes, count in elements of T
+  template <typename T>
+  BufferMapping<T> map_range(GLintptr offset, std::size_t count, GLbitfield access) {
+    auto data = map_range_raw(offset, sizeof(T) * count, access);
+    return BufferMapping<T>{_id, offset, static_cast<T*>(data), count};
+  }
+  void flush_mapped_range(GLintptr offset, GLsizeiptr size) const;
+  bool unmap() const;
+
+  void invalidate_data();
+  void invalidate_sub_data(GLintptr offset, GLsizeiptr size);
+  // copies size bytes from source, which may be this buffer if the ranges do not overlap
+  void copy_sub_data(const Buffer& source, GLintptr source_offset, GLintptr offset, GLsizeiptr size);
   void set_sub_data(GLintptr offset, GLsizeiptr size, const void* data);
   void clear_sub_data(GLenum internal_format,
                       GLintptr offset,
@@ -43,6 +128,7 @@ class Buffer {
   void clear_data(GLenum internal_format, GLenum format, GLenum data_type, const void* data = nullptr);
 
  protected:
+  void* map_range_raw(GLintptr offset, GLsizeiptr size, GLbitfield access);
   GLint get_parameter(GLenum parameter) const;
   void destroy() const;
 
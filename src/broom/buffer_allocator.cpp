@@ -0,0 +1,217 @@
+#include <broom/buffer_allocator.hpp>
+
+namespace broom {
+
+namespace {
+
+GLintptr align_up(GLintptr offset, GLsizeiptr alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+BufferAllocator::BufferAllocator(GLsizeiptr block_size, GLbitfield storage_flags)
+    : _block_size{block_size}, _storage_flags{storage_flags}, _allocated{0} {
+  if (block_size <= 0) {
+    throw std::runtime_error("A buffer allocator needs a positive block size");
+  }
+}
+
+GLsizeiptr BufferAllocator::block_size() const {
+  return _block_size;
+}
+
+std::size_t BufferAllocator::block_count() const {
+  return _blocks.size();
+}
+
+const Buffer& BufferAllocator::buffer(unsigned int block) const {
+  return *_blocks.at(block).buffer;
+}
+
+GLsizeiptr BufferAllocator::allocated() const {
+  return _allocated;
+}
+
+GLsizeiptr BufferAllocator::capacity() const {
+  GLsizeiptr capacity = 0;
+  for (const auto& block : _blocks) {
+    capacity += block.size;
+  }
+  return capacity;
+}
+
+GLsizeiptr BufferAllocator::largest_free_range() const {
+  GLsizeiptr largest = 0;
+  for (const auto& block : _blocks) {
+    if (!block.free_sizes.empty()) {
+      largest = std::max(largest, block.free_sizes.rbegin()->first);
+    }
+  }
+  return largest;
+}
+
+BufferAllocation BufferAllocator::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+  if (size <= 0 || alignment <= 0) {
+    throw std::runtime_error("Buffer allocations need a positive size and alignment");
+  }
+
+  BufferAllocation allocation{0, nullptr, 0, 0};
+  for (unsigned int block = 0; block < _blocks.size(); ++block) {
+    if (allocate_from(block, size, alignment, allocation)) {
+      return allocation;
+    }
+  }
+
+  // a fresh block starts at offset 0 which satisfies any alignment
+  auto block = add_block(std::max(size, _block_size));
+  allocate_from(block, size, alignment, allocation);
+  return allocation;
+}
+
+void BufferAllocator::free(const BufferAllocation& allocation) {
+  if (!allocation.valid()) {
+    return;
+  }
+  auto& block = _blocks.at(allocation.block);
+  auto used = block.used.find(allocation.offset);
+  if (used == block.used.end()) {
+    spdlog::warn("Offset {} of buffer {} is not allocated", allocation.offset, block.buffer->id());
+    return;
+  }
+  _allocated -= used->second.size;
+  insert_free(block, used->first, used->second.size);
+  block.used.erase(used);
+}
+
+void BufferAllocator::write(const BufferAllocation& allocation, GLintptr offset, GLsizeiptr size, const void* data) {
+  if (offset + size > allocation.size) {
+    throw std::runtime_error("Write exceeds the buffer allocation");
+  }
+  _blocks.at(allocation.block).buffer->set_sub_data(allocation.offset + offset, size, data);
+}
+
+std::vector<BufferRelocation> BufferAllocator::compact() {
+  std::vector<BufferRelocation> relocations;
+  for (unsigned int index = 0; index < _blocks.size(); ++index) {
+    auto& block = _blocks[index];
+    // nothing to gain if the only free range is already at the end
+    if (block.free_ranges.empty() ||
+        (block.free_ranges.size() == 1 && block.free_ranges.begin()->first + block.free_ranges.begin()->second ==
+                                              block.size)) {
+      continue;
+    }
+
+    // ranges may overlap their new place, so pack them into a staging buffer and copy that back in one go
+    std::map<GLintptr, Used> packed;
+    GLintptr head = 0;
+    for (const auto& used : block.used) {
+      auto offset = align_up(head, used.second.alignment);
+      packed.emplace(offset, used.second);
+      if (offset != used.first) {
+        relocations.push_back(BufferRelocation{index, used.first, offset, used.second.size});
+      }
+      head = offset + used.second.size;
+    }
+
+    if (head > 0) {
+      Buffer staging;
+      staging.set_storage(head);
+      auto source = block.used.begin();
+      for (const auto& used : packed) {
+        staging.copy_sub_data(*block.buffer, source->first, used.first, used.second.size);
+        ++source;
+      }
+      block.buffer->copy_sub_data(staging, 0, 0, head);
+    }
+
+    block.used = std::move(packed);
+    block.free_ranges.clear();
+    block.free_sizes.clear();
+    GLintptr previous_end = 0;
+    for (const auto& used : block.used) {
+      if (used.first > previous_end) {
+        insert_free(block, previous_end, used.first - previous_end);
+      }
+      previous_end = used.first + used.second.size;
+    }
+    if (previous_end < block.size) {
+      insert_free(block, previous_end, block.size - previous_end);
+    }
+  }
+  spdlog::debug("Compacted buffer allocator, moved {} allocations", relocations.size());
+  return relocations;
+}
+
+unsigned int BufferAllocator::add_block(GLsizeiptr size) {
+  Block block;
+  block.buffer = std::make_unique<Buffer>();
+  block.buffer->set_storage(size, nullptr, _storage_flags);
+  block.size = size;
+  insert_free(block, 0, size);
+  _blocks.push_back(std::move(block));
+  spdlog::debug("Added block {} of {} bytes to buffer allocator", _blocks.back().buffer->id(), size);
+  return _blocks.size() - 1;
+}
+
+bool BufferAllocator::allocate_from(unsigned int index,
+                                    GLsizeiptr size,
+                                    GLsizeiptr alignment,
+                                    BufferAllocation& allocation) {
+  auto& block = _blocks[index];
+  // best fit, the smallest free range that still holds the aligned allocation
+  for (auto candidate = block.free_sizes.lower_bound(size); candidate != block.free_sizes.end(); ++candidate) {
+    auto range_offset = candidate->second;
+    auto range_size = candidate->first;
+    auto offset = align_up(range_offset, alignment);
+    if (offset + size > range_offset + range_size) {
+      continue;
+    }
+
+    erase_free(block, block.free_ranges.find(range_offset));
+    if (offset > range_offset) {
+      insert_free(block, range_offset, offset - range_offset);
+    }
+    if (offset + size < range_offset + range_size) {
+      insert_free(block, offset + size, range_offset + range_size - offset - size);
+    }
+    block.used.emplace(offset, Used{size, alignment});
+    _allocated += size;
+    allocation = BufferAllocation{index, block.buffer.get(), offset, size};
+    return true;
+  }
+  return false;
+}
+
+void BufferAllocator::insert_free(Block& block, GLintptr offset, GLsizeiptr size) {
+  // coalesce with the free neighbours on both sides
+  auto next = block.free_ranges.lower_bound(offset);
+  if (next != block.free_ranges.end() && offset + size == next->first) {
+    size += next->second;
+    next = std::next(next);
+    erase_free(block, std::prev(next));
+  }
+  if (next != block.free_ranges.begin()) {
+    auto previous = std::prev(next);
+    if (previous->first + previous->second == offset) {
+      offset = previous->first;
+      size += previous->second;
+      erase_free(block, previous);
+    }
+  }
+  block.free_ranges.emplace(offset, size);
+  block.free_sizes.emplace(size, offset);
+}
+
+void BufferAllocator::erase_free(Block& block, std::map<GLintptr, GLsizeiptr>::iterator range) {
+  auto sizes = block.free_sizes.equal_range(range->second);
+  for (auto it = sizes.first; it != sizes.second; ++it) {
+    if (it->second == range->first) {
+      block.free_sizes.erase(it);
+      break;
+    }
+  }
+  block.free_ranges.erase(range);
+}
+
+}  // namespace broom
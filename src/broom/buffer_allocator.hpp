@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/buffer.hpp>
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// A range carved out of one of the allocator's buffers, usable as a vertex buffer offset or, divided by the
+// vertex stride, as the base vertex of a draw.
+struct BufferAllocation {
+  unsigned int block;
+  const Buffer* buffer;
+  GLintptr offset;
+  GLsizeiptr size;
+
+  bool valid() const { return buffer != nullptr; }
+};
+
+// Where compact() moved an allocation to, the block and buffer stay the same for a block's allocations.
+struct BufferRelocation {
+  unsigned int block;
+  GLintptr old_offset;
+  GLintptr new_offset;
+  GLsizeiptr size;
+};
+
+// Suballocates vertex and index ranges from a few large immutable buffers, so that many small meshes share
+// one buffer object, one vertex array and can be merged into multi-draws.
+//
+// Free ranges are kept in best-fit order and coalesced with their neighbours on free. Alignments need not be
+// powers of two, allocating with the vertex stride as alignment keeps offset / stride a valid base vertex.
+class BufferAllocator {
+ public:
+  BufferAllocator(GLsizeiptr block_size, GLbitfield storage_flags = GL_DYNAMIC_STORAGE_BIT);
+  BufferAllocator(const BufferAllocator&) = delete;
+  BufferAllocator(BufferAllocator&&) = delete;
+
+  BufferAllocator& operator=(const BufferAllocator& other) = delete;
+  BufferAllocator& operator=(BufferAllocator&& other) = delete;
+
+  GLsizeiptr block_size() const;
+  std::size_t block_count() const;
+  const Buffer& buffer(unsigned int block) const;
+  // bytes handed out, without alignment padding which stays on the free list
+  GLsizeiptr allocated() const;
+  GLsizeiptr capacity() const;
+  GLsizeiptr largest_free_range() const;
+
+  // adds a new block when no existing one has room, larger than block_size() if the request needs it
+  BufferAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 1);
+  void free(const BufferAllocation& allocation);
+
+  // needs GL_DYNAMIC_STORAGE_BIT in the storage flags
+  template <typename T>
+  void write(const BufferAllocation& allocation, const std::vector<T>& vector) {
+    write(allocation, 0, sizeof(T) * vector.size(), vector.data());
+  }
+  void write(const BufferAllocation& allocation, GLintptr offset, GLsizeiptr size, const void* data);
+
+  // packs the allocations of fragmented blocks towards their start with copies on the GPU, the buffers stay
+  // the same but callers have to patch their offsets and base vertices with the returned relocations
+  std::vector<BufferRelocation> compact();
+
+ protected:
+  struct Used {
+    GLsizeiptr size;
+    GLsizeiptr alignment;
+  };
+
+  struct Block {
+    std::unique_ptr<Buffer> buffer;
+    GLsizeiptr size;
+    std::map<GLintptr, GLsizeiptr> free_ranges;
+    std::multimap<GLsizeiptr, GLintptr> free_sizes;
+    std::map<GLintptr, Used> used;
+  };
+
+  unsigned int add_block(GLsizeiptr size);
+  bool allocate_from(unsigned int block, GLsizeiptr size, GLsizeiptr alignment, BufferAllocation& allocation);
+  void insert_free(Block& block, GLintptr offset, GLsizeiptr size);
+  void erase_free(Block& block, std::map<GLintptr, GLsizeiptr>::iterator range);
+
+ protected:
+  GLsizeiptr _block_size;
+  GLbitfield _storage_flags;
+  std::vector<Block> _blocks;
+  GLsizeiptr _allocated;
+};
+
+}  // namespace broom
@@ -0,0 +1,305 @@
+#include <broom/compressed_image.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <broom/image.hpp>
+
+namespace broom {
+
+namespace {
+
+constexpr std::uint8_t ktx2_identifier[12] = {0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+constexpr std::uint32_t dds_magic = 0x20534444;  // "DDS "
+
+constexpr std::uint32_t four_cc(char a, char b, char c, char d) {
+  return static_cast<std::uint32_t>(a) | static_cast<std::uint32_t>(b) << 8 | static_cast<std::uint32_t>(c) << 16 |
+         static_cast<std::uint32_t>(d) << 24;
+}
+
+template <typename T>
+T read(const std::vector<std::uint8_t>& file, std::size_t offset) {
+  if (offset + sizeof(T) > file.size()) {
+    throw std::runtime_error("Unexpected end of compressed image file");
+  }
+  T value;
+  std::memcpy(&value, file.data() + offset, sizeof(T));
+  return value;
+}
+
+GLenum dds_four_cc_format(std::uint32_t code) {
+  switch (code) {
+    case four_cc('D', 'X', 'T', '1'):
+      return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case four_cc('D', 'X', 'T', '5'):
+      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case four_cc('A', 'T', 'I', '1'):
+    case four_cc('B', 'C', '4', 'U'):
+      return GL_COMPRESSED_RED_RGTC1;
+    case four_cc('A', 'T', 'I', '2'):
+    case four_cc('B', 'C', '5', 'U'):
+      return GL_COMPRESSED_RG_RGTC2;
+  }
+  return GL_NONE;
+}
+
+GLenum dxgi_format(std::uint32_t format) {
+  switch (format) {
+    case 71:  // DXGI_FORMAT_BC1_UNORM
+      return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case 72:  // DXGI_FORMAT_BC1_UNORM_SRGB
+      return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+    case 77:  // DXGI_FORMAT_BC3_UNORM
+      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case 78:  // DXGI_FORMAT_BC3_UNORM_SRGB
+      return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    case 80:  // DXGI_FORMAT_BC4_UNORM
+      return GL_COMPRESSED_RED_RGTC1;
+    case 81:  // DXGI_FORMAT_BC4_SNORM
+      return GL_COMPRESSED_SIGNED_RED_RGTC1;
+    case 83:  // DXGI_FORMAT_BC5_UNORM
+      return GL_COMPRESSED_RG_RGTC2;
+    case 84:  // DXGI_FORMAT_BC5_SNORM
+      return GL_COMPRESSED_SIGNED_RG_RGTC2;
+    case 98:  // DXGI_FORMAT_BC7_UNORM
+      return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case 99:  // DXGI_FORMAT_BC7_UNORM_SRGB
+      return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+  }
+  return GL_NONE;
+}
+
+GLenum vulkan_format(std::uint32_t format) {
+  switch (format) {
+    case 131:  // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+      return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case 132:  // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+      return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+    case 133:  // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+      return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case 134:  // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+      return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+    case 137:  // VK_FORMAT_BC3_UNORM_BLOCK
+      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case 138:  // VK_FORMAT_BC3_SRGB_BLOCK
+      return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+    case 139:  // VK_FORMAT_BC4_UNORM_BLOCK
+      return GL_COMPRESSED_RED_RGTC1;
+    case 140:  // VK_FORMAT_BC4_SNORM_BLOCK
+      return GL_COMPRESSED_SIGNED_RED_RGTC1;
+    case 141:  // VK_FORMAT_BC5_UNORM_BLOCK
+      return GL_COMPRESSED_RG_RGTC2;
+    case 142:  // VK_FORMAT_BC5_SNORM_BLOCK
+      return GL_COMPRESSED_SIGNED_RG_RGTC2;
+    case 145:  // VK_FORMAT_BC7_UNORM_BLOCK
+      return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case 146:  // VK_FORMAT_BC7_SRGB_BLOCK
+      return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+  }
+  return GL_NONE;
+}
+
+}  // namespace
+
+bool is_s3tc(GLenum internal_format) {
+  switch (internal_format) {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+      return true;
+  }
+  return false;
+}
+
+GLsizeiptr compressed_block_size(GLenum internal_format) {
+  switch (internal_format) {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RED_RGTC1:
+    case GL_COMPRESSED_SIGNED_RED_RGTC1:
+      return 8;
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RG_RGTC2:
+    case GL_COMPRESSED_SIGNED_RG_RGTC2:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+      return 16;
+  }
+  return 0;
+}
+
+CompressedImage::CompressedImage() : _internal_format{GL_NONE}, _width{0}, _height{0} {}
+
+CompressedImage CompressedImage::load_from_file(const std::string& filename) {
+  std::ifstream stream{filename, std::ios::binary};
+  if (!stream) {
+    spdlog::error("Failed to open compressed image '{}'", filename);
+    throw std::runtime_error("Failed to open compressed image \"" + filename + "\"");
+  }
+  std::vector<std::uint8_t> file{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+
+  try {
+    if (file.size() >= sizeof(ktx2_identifier) && std::equal(std::begin(ktx2_identifier), std::end(ktx2_identifier),
+                                                              file.begin())) {
+      return load_ktx2(std::move(file));
+    }
+    if (file.size() >= 4 && read<std::uint32_t>(file, 0) == dds_magic) {
+      return load_dds(std::move(file));
+    }
+    throw std::runtime_error("Unknown compressed image container");
+  } catch (const std::runtime_error& error) {
+    spdlog::error("Failed to load compressed image '{}': {}", filename, error.what());
+    throw;
+  }
+}
+
+CompressedImage CompressedImage::load_dds(std::vector<std::uint8_t> file) {
+  // DDS_HEADER follows the magic number, its pixel format starts at byte 72 of the header
+  constexpr std::size_t header = 4;
+  constexpr std::size_t pixel_format = header + 72;
+  constexpr std::uint32_t has_four_cc = 0x4;
+  constexpr std::uint32_t has_mip_map_count = 0x20000;
+
+  CompressedImage image;
+  image._height = read<std::uint32_t>(file, header + 8);
+  image._width = read<std::uint32_t>(file, header + 12);
+  // writers leave the mip map count undefined unless its flag is set, and no more levels than a full chain fit
+  auto levels = 1u;
+  if (read<std::uint32_t>(file, header + 4) & has_mip_map_count) {
+    levels = std::clamp(read<std::uint32_t>(file, header + 24), 1u, Image::mip_levels(image._width, image._height));
+  }
+  if (!(read<std::uint32_t>(file, pixel_format + 4) & has_four_cc)) {
+    throw std::runtime_error("Only block compressed DDS files are supported");
+  }
+
+  std::size_t data_offset = header + 124;
+  auto code = read<std::uint32_t>(file, pixel_format + 8);
+  if (code == four_cc('D', 'X', '1', '0')) {
+    // DDS_HEADER_DXT10 with the DXGI format, only plain 2D textures are supported
+    image._internal_format = dxgi_format(read<std::uint32_t>(file, data_offset));
+    if (read<std::uint32_t>(file, data_offset + 12) > 1) {
+      throw std::runtime_error("DDS texture arrays are not supported");
+    }
+    data_offset += 20;
+  } else {
+    image._internal_format = dds_four_cc_format(code);
+  }
+
+  image._data = std::move(file);
+  for (unsigned int level = 0; level < levels; ++level) {
+    auto offset = image._levels.empty() ? data_offset : image._levels.back().offset + image._levels.back().size;
+    auto width = std::max(1u, image._width >> level);
+    auto height = std::max(1u, image._height >> level);
+    auto size = ((width + 3) / 4) * ((height + 3) / 4) * compressed_block_size(image._internal_format);
+    image.add_level(offset, size);
+  }
+  return image;
+}
+
+CompressedImage CompressedImage::load_ktx2(std::vector<std::uint8_t> file) {
+  constexpr std::size_t header = sizeof(ktx2_identifier);
+  constexpr std::size_t level_index = header + 68;
+
+  CompressedImage image;
+  image._internal_format = vulkan_format(read<std::uint32_t>(file, header));
+  image._width = read<std::uint32_t>(file, header + 8);
+  image._height = read<std::uint32_t>(file, header + 12);
+  if (read<std::uint32_t>(file, header + 16) > 0 || read<std::uint32_t>(file, header + 20) > 0 ||
+      read<std::uint32_t>(file, header + 24) > 1) {
+    throw std::runtime_error("Only 2D KTX2 textures are supported");
+  }
+  if (read<std::uint32_t>(file, header + 32) != 0) {
+    throw std::runtime_error("Supercompressed KTX2 files are not supported");
+  }
+
+  // a level count of 0 asks for mipmaps to be generated, the file then holds only the base level
+  auto levels = std::clamp(read<std::uint32_t>(file, header + 28), 1u, Image::mip_levels(image._width, image._height));
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+  for (unsigned int level = 0; level < levels; ++level) {
+    auto offset = read<std::uint64_t>(file, level_index + level * 24);
+    auto size = read<std::uint64_t>(file, level_index + level * 24 + 8);
+    ranges.emplace_back(offset, size);
+  }
+
+  image._data = std::move(file);
+  for (const auto& range : ranges) {
+    image.add_level(range.first, range.second);
+  }
+  return image;
+}
+
+bool CompressedImage::is_compressed_file(const std::string& filename) {
+  auto dot = filename.rfind('.');
+  if (dot == std::string::npos) {
+    return false;
+  }
+  auto extension = filename.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return extension == "dds" || extension == "ktx2";
+}
+
+GLenum CompressedImage::internal_format() const {
+  return _internal_format;
+}
+
+unsigned int CompressedImage::width() const {
+  return _width;
+}
+
+unsigned int CompressedImage::height() const {
+  return _height;
+}
+
+unsigned int CompressedImage::levels() const {
+  return _levels.size();
+}
+
+const CompressedLevel& CompressedImage::level(unsigned int index) const {
+  return _levels.at(index);
+}
+
+const std::uint8_t* CompressedImage::level_data(unsigned int index) const {
+  return _data.data() + _levels.at(index).offset;
+}
+
+std::size_t CompressedImage::memory_size() const {
+  std::size_t size = 0;
+  for (const auto& level : _levels) {
+    size += level.size;
+  }
+  return size;
+}
+
+void CompressedImage::add_level(std::size_t offset, std::size_t size) {
+  auto block_size = compressed_block_size(_internal_format);
+  if (block_size == 0) {
+    throw std::runtime_error("Unsupported compressed texture format");
+  }
+  if (_width == 0 || _height == 0) {
+    throw std::runtime_error("Compressed image has no pixels");
+  }
+
+  unsigned int index = _levels.size();
+  if (index >= Image::mip_levels(_width, _height)) {
+    throw std::runtime_error("Compressed image has more levels than a full mip chain");
+  }
+  auto width = std::max(1u, _width >> index);
+  auto height = std::max(1u, _height >> index);
+  std::size_t expected = ((width + 3) / 4) * ((height + 3) / 4) * block_size;
+  if (size < expected || offset > _data.size() || size > _data.size() - offset) {
+    throw std::runtime_error("Compressed image level " + std::to_string(index) + " is truncated");
+  }
+  _levels.push_back(CompressedLevel{width, height, offset, expected});
+}
+
+}  // namespace broom
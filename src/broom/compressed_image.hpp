@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+struct CompressedLevel {
+  unsigned int width;
+  unsigned int height;
+  std::size_t offset;
+  std::size_t size;
+};
+
+// Block compressed (BC1, BC3, BC4, BC5 or BC7) pixels and their stored mip chain, read from a DDS or KTX2
+// container without decompressing them. Rows keep the orientation of the file, which for both containers
+// starts at the top of the image, so such textures are usually authored flipped for GL.
+class CompressedImage {
+ public:
+  CompressedImage();
+
+  // the container is detected from the file's magic number
+  static CompressedImage load_from_file(const std::string& filename);
+  static CompressedImage load_dds(std::vector<std::uint8_t> file);
+  static CompressedImage load_ktx2(std::vector<std::uint8_t> file);
+  // whether the extension names a container this class reads
+  static bool is_compressed_file(const std::string& filename);
+
+  GLenum internal_format() const;
+  unsigned int width() const;
+  unsigned int height() const;
+  unsigned int levels() const;
+  const CompressedLevel& level(unsigned int index) const;
+  const std::uint8_t* level_data(unsigned int index) const;
+  // bytes of all stored levels, which is also what the texture occupies in GPU memory
+  std::size_t memory_size() const;
+
+ protected:
+  // appends the next smaller level, checking that it lies within the file and is large enough
+  void add_level(std::size_t offset, std::size_t size);
+
+ protected:
+  GLenum _internal_format;
+  unsigned int _width;
+  unsigned int _height;
+  std::vector<CompressedLevel> _levels;
+  std::vector<std::uint8_t> _data;
+};
+
+// bytes per 4x4 block of a block compressed format, 0 for other formats
+GLsizeiptr compressed_block_size(GLenum internal_format);
+// BC1 and BC3 formats, which need GL_EXT_texture_compression_s3tc
+bool is_s3tc(GLenum internal_format);
+
+}  // namespace broom
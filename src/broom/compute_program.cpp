@@ -0,0 +1,84 @@
+#include <broom/compute_program.hpp>
+
+namespace broom {
+
+ComputeProgram::ComputeProgram(const Shader& shader) : _work_group_size{1, 1, 1}, _max_work_groups{0, 0, 0} {
+  init(shader);
+}
+
+ComputeProgram::ComputeProgram(const std::string& filename, const std::vector<std::string>& defines)
+    : _work_group_size{1, 1, 1}, _max_work_groups{0, 0, 0} {
+  Shader shader{GL_COMPUTE_SHADER};
+  shader.set_source(load_shader_source(filename, defines));
+  if (!shader.compile()) {
+    throw std::runtime_error("Failed to compile compute shader from file \"" + filename + "\"");
+  }
+  init(shader);
+}
+
+const glm::uvec3& ComputeProgram::work_group_size() const {
+  return _work_group_size;
+}
+
+glm::uvec3 ComputeProgram::work_groups(const glm::uvec3& invocations) const {
+  return glm::uvec3{(invocations.x + _work_group_size.x - 1) / _work_group_size.x,
+                    (invocations.y + _work_group_size.y - 1) / _work_group_size.y,
+                    (invocations.z + _work_group_size.z - 1) / _work_group_size.z};
+}
+
+void ComputeProgram::dispatch(GLuint groups_x, GLuint groups_y, GLuint groups_z) const {
+  if (groups_x > _max_work_groups.x || groups_y > _max_work_groups.y || groups_z > _max_work_groups.z) {
+    spdlog::error("Dispatch of {}x{}x{} work groups exceeds the limit of {}x{}x{}", groups_x, groups_y, groups_z,
+                  _max_work_groups.x, _max_work_groups.y, _max_work_groups.z);
+    throw std::runtime_error("Too many work groups!");
+  }
+  use();
+  glDispatchCompute(groups_x, groups_y, groups_z);
+}
+
+void ComputeProgram::dispatch_invocations(GLuint invocations_x, GLuint invocations_y, GLuint invocations_z) const {
+  auto groups = work_groups(glm::uvec3{invocations_x, invocations_y, invocations_z});
+  dispatch(groups.x, groups.y, groups.z);
+}
+
+void ComputeProgram::dispatch_indirect(const Buffer& buffer, GLintptr offset) const {
+  use();
+  buffer.bind(GL_DISPATCH_INDIRECT_BUFFER);
+  glDispatchComputeIndirect(offset);
+}
+
+bool ComputeProgram::bind_storage_buffer(std::uint64_t name_hash,
+                                         const Buffer& buffer,
+                                         GLintptr offset,
+                                         GLsizeiptr size) const {
+  auto block = storage_blocks().find(name_hash);
+  if (!block) {
+    return false;
+  }
+  buffer.bind_range(GL_SHADER_STORAGE_BUFFER, block->binding, offset, size > 0 ? size : buffer.size() - offset);
+  return true;
+}
+
+void ComputeProgram::init(const Shader& shader) {
+  if (shader.type() != GL_COMPUTE_SHADER) {
+    throw std::runtime_error("Compute programs need a compute shader");
+  }
+  attach_shader(shader);
+  if (!link()) {
+    throw std::runtime_error("Failed to link compute program");
+  }
+  detach_shader(shader);
+
+  GLint size[3];
+  glGetProgramiv(_id, GL_COMPUTE_WORK_GROUP_SIZE, size);
+  _work_group_size = glm::uvec3{size[0], size[1], size[2]};
+  for (GLuint i = 0; i < 3; ++i) {
+    GLint count = 0;
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, i, &count);
+    _max_work_groups[i] = count;
+  }
+  spdlog::debug("Linked compute program {} with work groups of {}x{}x{}", _id, _work_group_size.x,
+                _work_group_size.y, _work_group_size.z);
+}
+
+}  // namespace broom
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/buffer.hpp>
+#include <broom/memory_barrier.hpp>
+#include <broom/opengl.hpp>
+#include <broom/program.hpp>
+#include <broom/shader.hpp>
+#include <broom/state_cache.hpp>
+
+namespace broom {
+
+// A program with a single compute stage, e.g. for particle simulation, culling or skinning on the GPU.
+//
+// Dispatches use the program first. Results written to storage buffers or images are only visible to later
+// commands after a memory_barrier() for the way they are read.
+class ComputeProgram : public Program {
+ public:
+  // throws if the shader is no compute shader or linking fails
+  ComputeProgram(const Shader& shader);
+  ComputeProgram(const std::string& filename, const std::vector<std::string>& defines = {});
+
+  // the local_size the shader declares
+  const glm::uvec3& work_group_size() const;
+  // enough work groups to cover the invocations, shaders have to skip the excess ones
+  glm::uvec3 work_groups(const glm::uvec3& invocations) const;
+
+  void dispatch(GLuint groups_x, GLuint groups_y = 1, GLuint groups_z = 1) const;
+  void dispatch_invocations(GLuint invocations_x, GLuint invocations_y = 1, GLuint invocations_z = 1) const;
+  // the buffer holds the three GLuint group counts at offset
+  void dispatch_indirect(const Buffer& buffer, GLintptr offset = 0) const;
+
+  // binds the buffer range at the binding of the named storage block, size 0 binds the rest of the buffer,
+  // false if the program has no such active block
+  bool bind_storage_buffer(std::uint64_t name_hash,
+                           const Buffer& buffer,
+                           GLintptr offset = 0,
+                           GLsizeiptr size = 0) const;
+
+ protected:
+  void init(const Shader& shader);
+
+ protected:
+  glm::uvec3 _work_group_size;
+  glm::uvec3 _max_work_groups;
+};
+
+}  // namespace broom
@@ -0,0 +1,50 @@
+#include <broom/draw.hpp>
+
+namespace broom {
+
+GLsizeiptr index_type_size(GLenum index_type) {
+  switch (index_type) {
+    case GL_UNSIGNED_BYTE:
+      return 1;
+    case GL_UNSIGNED_SHORT:
+      return 2;
+    case GL_UNSIGNED_INT:
+      return 4;
+  }
+  return 0;
+}
+
+void draw_arrays(GLenum mode, GLint first, GLsizei count) {
+  glDrawArrays(mode, first, count);
+}
+
+void draw_elements(GLenum mode, GLsizei count, GLenum index_type, GLuint first_index, GLint base_vertex) {
+  auto offset = static_cast<GLintptr>(first_index) * index_type_size(index_type);
+  glDrawElementsBaseVertex(mode, count, index_type, reinterpret_cast<const void*>(offset), base_vertex);
+}
+
+void draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instance_count, GLuint base_instance) {
+  glDrawArraysInstancedBaseInstance(mode, first, count, instance_count, base_instance);
+}
+
+void draw_elements_instanced(GLenum mode,
+                             GLsizei count,
+                             GLenum index_type,
+                             GLsizei instance_count,
+                             GLuint first_index,
+                             GLint base_vertex,
+                             GLuint base_instance) {
+  auto offset = static_cast<GLintptr>(first_index) * index_type_size(index_type);
+  glDrawElementsInstancedBaseVertexBaseInstance(mode, count, index_type, reinterpret_cast<const void*>(offset),
+                                                instance_count, base_vertex, base_instance);
+}
+
+void multi_draw_arrays_indirect(GLenum mode, GLintptr offset, GLsizei draw_count, GLsizei stride) {
+  glMultiDrawArraysIndirect(mode, reinterpret_cast<const void*>(offset), draw_count, stride);
+}
+
+void multi_draw_elements_indirect(GLenum mode, GLenum index_type, GLintptr offset, GLsizei draw_count, GLsizei stride) {
+  glMultiDrawElementsIndirect(mode, index_type, reinterpret_cast<const void*>(offset), draw_count, stride);
+}
+
+}  // namespace broom
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// layouts mandated by the GL specification for indirect draws
+struct DrawArraysIndirectCommand {
+  GLuint count;
+  GLuint instance_count;
+  GLuint first;
+  GLuint base_instance;
+};
+
+struct DrawElementsIndirectCommand {
+  GLuint count;
+  GLuint instance_count;
+  GLuint first_index;
+  GLint base_vertex;
+  GLuint base_instance;
+};
+
+GLsizeiptr index_type_size(GLenum index_type);
+
+// draws from the currently bound vertex array, first_index is counted in indices, not bytes
+void draw_arrays(GLenum mode, GLint first, GLsizei count);
+void draw_elements(GLenum mode, GLsizei count, GLenum index_type, GLuint first_index = 0, GLint base_vertex = 0);
+
+void draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instance_count, GLuint base_instance = 0);
+void draw_elements_instanced(GLenum mode,
+                             GLsizei count,
+                             GLenum index_type,
+                             GLsizei instance_count,
+                             GLuint first_index = 0,
+                             GLint base_vertex = 0,
+                             GLuint base_instance = 0);
+
+// indirect draws read their commands from the buffer bound to GL_DRAW_INDIRECT_BUFFER, offsets are in bytes
+void multi_draw_arrays_indirect(GLenum mode, GLintptr offset, GLsizei draw_count, GLsizei stride = 0);
+void multi_draw_elements_indirect(GLenum mode,
+                                  GLenum index_type,
+                                  GLintptr offset,
+                                  GLsizei draw_count,
+                                  GLsizei stride = 0);
+
+}  // namespace broom
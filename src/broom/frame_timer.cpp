@@ -0,0 +1,237 @@
+#include <broom/frame_timer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace broom {
+
+const char* timer_scope_name(TimerScope scope) {
+  switch (scope) {
+    case TimerScope::cpu_frame:
+      return "cpu frame";
+    case TimerScope::cpu_draw:
+      return "cpu draw";
+    case TimerScope::cpu_swap:
+      return "cpu swap";
+    case TimerScope::cpu_update:
+      return "cpu update";
+    case TimerScope::gpu_frame:
+      return "gpu frame";
+    case TimerScope::gpu_draw:
+      return "gpu draw";
+  }
+  return "unknown";
+}
+
+RollingStatistics::RollingStatistics(std::size_t capacity) : _capacity{std::max<std::size_t>(capacity, 1)}, _next{0} {
+  _values.reserve(_capacity);
+}
+
+std::size_t RollingStatistics::size() const {
+  return _values.size();
+}
+
+std::size_t RollingStatistics::capacity() const {
+  return _capacity;
+}
+
+double RollingStatistics::last() const {
+  if (_values.empty()) {
+    return 0.0;
+  }
+  return _values[(_next + _capacity - 1) % _capacity];
+}
+
+void RollingStatistics::add(double value) {
+  if (_values.size() < _capacity) {
+    _values.push_back(value);
+  } else {
+    _values[_next] = value;
+  }
+  _next = (_next + 1) % _capacity;
+}
+
+void RollingStatistics::clear() {
+  _values.clear();
+  _next = 0;
+}
+
+FrameStatistics RollingStatistics::statistics(double bucket_width, std::size_t buckets) const {
+  FrameStatistics result{_values.size(), 0.0, 0.0, 0.0, 0.0, bucket_width, std::vector<std::size_t>(buckets, 0)};
+  if (_values.empty()) {
+    return result;
+  }
+
+  auto [min, max] = std::minmax_element(_values.begin(), _values.end());
+  result.min = *min;
+  result.max = *max;
+  result.mean = std::accumulate(_values.begin(), _values.end(), 0.0) / _values.size();
+
+  // the window is small, so a partial sort of a copy is cheap enough for an on-demand query
+  std::vector<double> sorted{_values};
+  auto rank = static_cast<std::size_t>(std::ceil(0.99 * sorted.size())) - 1;
+  std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+  result.p99 = sorted[rank];
+
+  if (buckets > 0 && bucket_width > 0.0) {
+    for (auto value : _values) {
+      auto bucket = static_cast<std::size_t>(std::max(value, 0.0) / bucket_width);
+      ++result.histogram[std::min(bucket, buckets - 1)];
+    }
+  }
+  return result;
+}
+
+FrameTimer::FrameTimer(std::size_t history)
+    : _history{RollingStatistics{history}, RollingStatistics{history}, RollingStatistics{history},
+               RollingStatistics{history}, RollingStatistics{history}, RollingStatistics{history}},
+      _queries{},
+      _frame_count{0},
+      _dropped_gpu_frames{0},
+      _initialized{false} {}
+
+FrameTimer::~FrameTimer() {
+  destroy();
+}
+
+void FrameTimer::init() {
+  if (_initialized) {
+    return;
+  }
+  for (auto& queries : _queries) {
+    glCreateQueries(GL_TIMESTAMP, 1, &queries.frame_begin);
+    glCreateQueries(GL_TIMESTAMP, 1, &queries.frame_end);
+    glCreateQueries(GL_TIMESTAMP, 1, &queries.draw_begin);
+    glCreateQueries(GL_TIMESTAMP, 1, &queries.draw_end);
+    queries.pending = false;
+    queries.draw_pending = false;
+  }
+  _initialized = true;
+}
+
+void FrameTimer::destroy() {
+  if (!_initialized) {
+    return;
+  }
+  for (auto& queries : _queries) {
+    glDeleteQueries(1, &queries.frame_begin);
+    glDeleteQueries(1, &queries.frame_end);
+    glDeleteQueries(1, &queries.draw_begin);
+    glDeleteQueries(1, &queries.draw_end);
+  }
+  _initialized = false;
+}
+
+std::size_t FrameTimer::frame_count() const {
+  return _frame_count;
+}
+
+std::size_t FrameTimer::dropped_gpu_frames() const {
+  return _dropped_gpu_frames;
+}
+
+const RollingStatistics& FrameTimer::history(TimerScope scope) const {
+  return _history[static_cast<std::size_t>(scope)];
+}
+
+FrameStatistics FrameTimer::statistics(TimerScope scope, double bucket_width, std::size_t buckets) const {
+  return history(scope).statistics(bucket_width, buckets);
+}
+
+void FrameTimer::log_statistics() const {
+  for (std::size_t i = 0; i < scope_count; ++i) {
+    auto scope = static_cast<TimerScope>(i);
+    auto stats = statistics(scope);
+    if (stats.samples == 0) {
+      continue;
+    }
+    spdlog::info("{:>10}: min {:.3f} ms, mean {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms ({} samples)",
+                 timer_scope_name(scope), stats.min, stats.mean, stats.p99, stats.max, stats.samples);
+  }
+}
+
+void FrameTimer::begin_frame() {
+  begin(TimerScope::cpu_frame);
+  if (_initialized) {
+    auto& queries = _queries[_frame_count % query_ring_size];
+    collect_gpu_results(queries);
+    glQueryCounter(queries.frame_begin, GL_TIMESTAMP);
+  }
+}
+
+void FrameTimer::end_frame() {
+  if (_initialized) {
+    auto& queries = _queries[_frame_count % query_ring_size];
+    glQueryCounter(queries.frame_end, GL_TIMESTAMP);
+    queries.pending = true;
+  }
+  end(TimerScope::cpu_frame);
+  ++_frame_count;
+}
+
+void FrameTimer::collect_pending() {
+  if (!_initialized) {
+    return;
+  }
+  // oldest first, the slot of the next frame holds the oldest results
+  for (std::size_t i = 0; i < query_ring_size; ++i) {
+    collect_gpu_results(_queries[(_frame_count + i) % query_ring_size]);
+  }
+}
+
+// GPU scopes use timestamp pairs rather than GL_TIME_ELAPSED, those cannot nest with queries of the application
+void FrameTimer::begin(TimerScope scope) {
+  if (scope == TimerScope::gpu_draw) {
+    if (_initialized) {
+      glQueryCounter(_queries[_frame_count % query_ring_size].draw_begin, GL_TIMESTAMP);
+    }
+    return;
+  }
+  _begin[static_cast<std::size_t>(scope)] = Clock::now();
+}
+
+void FrameTimer::end(TimerScope scope) {
+  if (scope == TimerScope::gpu_draw) {
+    if (_initialized) {
+      auto& queries = _queries[_frame_count % query_ring_size];
+      glQueryCounter(queries.draw_end, GL_TIMESTAMP);
+      queries.draw_pending = true;
+    }
+    return;
+  }
+  auto index = static_cast<std::size_t>(scope);
+  std::chrono::duration<double, std::milli> elapsed = Clock::now() - _begin[index];
+  _history[index].add(elapsed.count());
+}
+
+void FrameTimer::collect_gpu_results(GpuQueries& queries) {
+  if (!queries.pending) {
+    return;
+  }
+  queries.pending = false;
+
+  // the end timestamp is the last query of the frame, once it is available all others are too
+  GLuint available = GL_FALSE;
+  glGetQueryObjectuiv(queries.frame_end, GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE) {
+    // never wait for the GPU, losing a sample is better than stalling the frame
+    ++_dropped_gpu_frames;
+    return;
+  }
+
+  GLuint64 frame_begin, frame_end;
+  glGetQueryObjectui64v(queries.frame_begin, GL_QUERY_RESULT, &frame_begin);
+  glGetQueryObjectui64v(queries.frame_end, GL_QUERY_RESULT, &frame_end);
+  _history[static_cast<std::size_t>(TimerScope::gpu_frame)].add((frame_end - frame_begin) / 1.0e6);
+
+  if (queries.draw_pending) {
+    GLuint64 draw_begin, draw_end;
+    glGetQueryObjectui64v(queries.draw_begin, GL_QUERY_RESULT, &draw_begin);
+    glGetQueryObjectui64v(queries.draw_end, GL_QUERY_RESULT, &draw_end);
+    _history[static_cast<std::size_t>(TimerScope::gpu_draw)].add((draw_end - draw_begin) / 1.0e6);
+    queries.draw_pending = false;
+  }
+}
+
+}  // namespace broom
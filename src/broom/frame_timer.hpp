@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+enum class TimerScope { cpu_frame, cpu_draw, cpu_swap, cpu_update, gpu_frame, gpu_draw };
+
+const char* timer_scope_name(TimerScope scope);
+
+// all durations in milliseconds
+struct FrameStatistics {
+  std::size_t samples;
+  double min;
+  double mean;
+  double p99;
+  double max;
+  double bucket_width;
+  // the last bucket collects everything above the histogram range
+  std::vector<std::size_t> histogram;
+};
+
+class RollingStatistics {
+ public:
+  RollingStatistics(std::size_t capacity);
+
+  std::size_t size() const;
+  std::size_t capacity() const;
+  double last() const;
+
+  void add(double value);
+  void clear();
+  FrameStatistics statistics(double bucket_width = 1.0, std::size_t buckets = 34) const;
+
+ protected:
+  std::vector<double> _values;
+  std::size_t _capacity;
+  std::size_t _next;
+};
+
+class FrameTimer {
+ public:
+  // number of frames the GPU results lag behind, reading them earlier would stall the pipeline
+  static constexpr std::size_t query_ring_size = 4;
+  static constexpr std::size_t scope_count = 6;
+
+  FrameTimer(std::size_t history = 512);
+  FrameTimer(const FrameTimer&) = delete;
+  FrameTimer(FrameTimer&&) = delete;
+  ~FrameTimer();
+
+  FrameTimer& operator=(const FrameTimer& other) = delete;
+  FrameTimer& operator=(FrameTimer&& other) = delete;
+
+  // needs a current OpenGL context
+  void init();
+  void destroy();
+
+  std::size_t frame_count() const;
+  std::size_t dropped_gpu_frames() const;
+  const RollingStatistics& history(TimerScope scope) const;
+  FrameStatistics statistics(TimerScope scope, double bucket_width = 1.0, std::size_t buckets = 34) const;
+  void log_statistics() const;
+
+  void begin_frame();
+  void end_frame();
+  void begin(TimerScope scope);
+  void end(TimerScope scope);
+  // reads the results of all frames still in flight, only without stalling after glFinish()
+  void collect_pending();
+
+ protected:
+  using Clock = std::chrono::steady_clock;
+
+  struct GpuQueries {
+    GLuint frame_begin;
+    GLuint frame_end;
+    GLuint draw_begin;
+    GLuint draw_end;
+    bool pending;
+    bool draw_pending;
+  };
+
+  void collect_gpu_results(GpuQueries& queries);
+
+ protected:
+  std::array<RollingStatistics, scope_count> _history;
+  std::array<Clock::time_point, scope_count> _begin;
+  std::array<GpuQueries, query_ring_size> _queries;
+  std::size_t _frame_count;
+  std::size_t _dropped_gpu_frames;
+  bool _initialized;
+};
+
+}  // namespace broom
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace broom {
+
+constexpr std::uint64_t fnv1a_offset_basis = 14695981039346656037ull;
+constexpr std::uint64_t fnv1a_prime = 1099511628211ull;
+
+// 64 bit FNV-1a, pass the previous result as hash to continue over several pieces of data
+constexpr std::uint64_t fnv1a(std::string_view data, std::uint64_t hash = fnv1a_offset_basis) {
+  for (char c : data) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= fnv1a_prime;
+  }
+  return hash;
+}
+
+inline namespace literals {
+
+// hashes names at compile time, e.g. program.uniform_location("model"_hash)
+constexpr std::uint64_t operator""_hash(const char* string, std::size_t length) {
+  return fnv1a(std::string_view{string, length});
+}
+
+}  // namespace literals
+
+}  // namespace broom
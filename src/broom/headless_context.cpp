@@ -0,0 +1,181 @@
+#include <broom/headless_context.hpp>
+
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace broom {
+
+namespace {
+
+bool has_extension(const char* extensions, const std::string& name) {
+  if (nullptr == extensions) {
+    return false;
+  }
+  std::string list{" "};
+  list.append(extensions).append(" ");
+  return list.find(" " + name + " ") != std::string::npos;
+}
+
+EGLDisplay get_display() {
+  // prefer Mesa's surfaceless platform, it works without any display server or GPU device node
+  auto client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  if (has_extension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+    auto get_platform_display =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (get_platform_display) {
+      auto display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+      if (display != EGL_NO_DISPLAY) {
+        return display;
+      }
+    }
+  }
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+}  // namespace
+
+HeadlessContext::HeadlessContext(const std::string& name, const glm::uvec2& resolution)
+    : _name{name},
+      _resolution{resolution},
+      _display{EGL_NO_DISPLAY},
+      _context{EGL_NO_CONTEXT},
+      _surface{EGL_NO_SURFACE},
+      _framebuffer{0},
+      _color_buffer{0},
+      _depth_buffer{0} {
+  _display = get_display();
+  EGLint major, minor;
+  if (_display == EGL_NO_DISPLAY || !eglInitialize(_display, &major, &minor)) {
+    spdlog::error("Failed to initialize EGL display for \"{}\"", _name);
+    throw std::runtime_error("Failed to initialize EGL display!");
+  }
+  spdlog::info("Headless context \"{}\" uses EGL {}.{} ({}) at {}x{}", _name, major, minor,
+               eglQueryString(_display, EGL_VENDOR), _resolution.x, _resolution.y);
+
+  if (!eglBindAPI(EGL_OPENGL_API)) {
+    destroy();
+    throw std::runtime_error("Failed to bind the OpenGL API for EGL!");
+  }
+
+  // without surfaceless contexts fall back to a pbuffer of the requested size
+  bool surfaceless = has_extension(eglQueryString(_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+  // clang-format off
+  const EGLint config_attributes[] = {
+    EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 24,
+    EGL_NONE
+  };
+  // clang-format on
+  EGLConfig config;
+  EGLint num_configs = 0;
+  if (!eglChooseConfig(_display, config_attributes, &config, 1, &num_configs) || num_configs < 1) {
+    spdlog::error("No suitable EGL config for headless context \"{}\"", _name);
+    destroy();
+    throw std::runtime_error("Failed to choose EGL config!");
+  }
+
+  // clang-format off
+  const EGLint context_attributes[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 4,
+    EGL_CONTEXT_MINOR_VERSION, 5,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifndef NDEBUG
+    EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+    EGL_NONE
+  };
+  // clang-format on
+  _context = eglCreateContext(_display, config, EGL_NO_CONTEXT, context_attributes);
+  if (_context == EGL_NO_CONTEXT) {
+    spdlog::error("Failed to create EGL context for \"{}\"", _name);
+    destroy();
+    throw std::runtime_error("Failed to create EGL context!");
+  }
+
+  if (!surfaceless) {
+    const EGLint surface_attributes[] = {EGL_WIDTH, static_cast<EGLint>(_resolution.x), EGL_HEIGHT,
+                                         static_cast<EGLint>(_resolution.y), EGL_NONE};
+    _surface = eglCreatePbufferSurface(_display, config, surface_attributes);
+    if (_surface == EGL_NO_SURFACE) {
+      spdlog::error("Failed to create EGL pbuffer surface for \"{}\"", _name);
+      destroy();
+      throw std::runtime_error("Failed to create EGL pbuffer surface!");
+    }
+  }
+
+  if (!eglMakeCurrent(_display, _surface, _surface, _context)) {
+    spdlog::error("Failed to make EGL context of \"{}\" current", _name);
+    destroy();
+    throw std::runtime_error("Failed to make EGL context current!");
+  }
+}
+
+HeadlessContext::~HeadlessContext() {
+  destroy();
+}
+
+void* HeadlessContext::get_proc_address(const char* name) {
+  return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+const glm::uvec2& HeadlessContext::resolution() const {
+  return _resolution;
+}
+
+GLuint HeadlessContext::framebuffer() const {
+  return _framebuffer;
+}
+
+void HeadlessContext::create_framebuffer() {
+  // render into an offscreen framebuffer, a surfaceless context has no default framebuffer at all
+  glCreateRenderbuffers(1, &_color_buffer);
+  glNamedRenderbufferStorage(_color_buffer, GL_RGBA8, _resolution.x, _resolution.y);
+  glCreateRenderbuffers(1, &_depth_buffer);
+  glNamedRenderbufferStorage(_depth_buffer, GL_DEPTH24_STENCIL8, _resolution.x, _resolution.y);
+
+  glCreateFramebuffers(1, &_framebuffer);
+  glNamedFramebufferRenderbuffer(_framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _color_buffer);
+  glNamedFramebufferRenderbuffer(_framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depth_buffer);
+
+  if (glCheckNamedFramebufferStatus(_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    spdlog::error("Offscreen framebuffer of \"{}\" is incomplete", _name);
+    throw std::runtime_error("Failed to create offscreen framebuffer!");
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+  spdlog::debug("Created {}x{} offscreen framebuffer for \"{}\"", _resolution.x, _resolution.y, _name);
+}
+
+void HeadlessContext::swap_buffers() const {
+  // nothing is presented, but the frame's commands should be submitted like a real swap would
+  glFlush();
+}
+
+void HeadlessContext::destroy() {
+  if (_framebuffer != 0) {
+    glDeleteFramebuffers(1, &_framebuffer);
+    glDeleteRenderbuffers(1, &_color_buffer);
+    glDeleteRenderbuffers(1, &_depth_buffer);
+    _framebuffer = 0;
+  }
+  if (_display != EGL_NO_DISPLAY) {
+    eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (_surface != EGL_NO_SURFACE) {
+      eglDestroySurface(_display, _surface);
+    }
+    if (_context != EGL_NO_CONTEXT) {
+      eglDestroyContext(_display, _context);
+    }
+    eglTerminate(_display);
+    _display = EGL_NO_DISPLAY;
+  }
+}
+
+}  // namespace broom
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+class HeadlessContext {
+ public:
+  HeadlessContext(const std::string& name, const glm::uvec2& resolution);
+  HeadlessContext(const HeadlessContext&) = delete;
+  HeadlessContext(HeadlessContext&&) = delete;
+  ~HeadlessContext();
+
+  HeadlessContext& operator=(const HeadlessContext& other) = delete;
+  HeadlessContext& operator=(HeadlessContext&& other) = delete;
+
+  static void* get_proc_address(const char* name);
+
+  // getters
+  const glm::uvec2& resolution() const;
+  GLuint framebuffer() const;
+
+  // needs a loaded OpenGL, i.e. must be called after gladLoadGLLoader
+  void create_framebuffer();
+  void swap_buffers() const;
+
+ protected:
+  void destroy();
+
+ protected:
+  std::string _name;
+  glm::uvec2 _resolution;
+
+  // EGL handles, kept as void* so that EGL headers do not leak into the public API
+  void* _display;
+  void* _context;
+  void* _surface;
+
+  GLuint _framebuffer;
+  GLuint _color_buffer;
+  GLuint _depth_buffer;
+};
+
+}  // namespace broom
@@ -0,0 +1,366 @@
+#include <broom/image.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <array>
+#include <cmath>
+#include <future>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BROOM_IMAGE_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define BROOM_IMAGE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace broom {
+
+namespace {
+
+void expand_rgb_to_rgba_scalar(const std::uint8_t* source, std::uint8_t* destination, std::size_t pixels) {
+  for (std::size_t i = 0; i < pixels; ++i) {
+    destination[4 * i + 0] = source[3 * i + 0];
+    destination[4 * i + 1] = source[3 * i + 1];
+    destination[4 * i + 2] = source[3 * i + 2];
+    destination[4 * i + 3] = 0xff;
+  }
+}
+
+#ifdef BROOM_IMAGE_SSSE3
+__attribute__((target("ssse3"))) void expand_rgb_to_rgba_ssse3(const std::uint8_t* source,
+                                                               std::uint8_t* destination,
+                                                               std::size_t pixels) {
+  // spreads four RGB pixels of a 16 byte load over 16 bytes and sets their alpha
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+  std::size_t i = 0;
+  // a load reads 4 bytes past the 4 pixels it uses, stop early enough to stay inside the source
+  for (; i + 6 <= pixels; i += 4) {
+    __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 3 * i));
+    __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 4 * i), rgba);
+  }
+  expand_rgb_to_rgba_scalar(source + 3 * i, destination + 4 * i, pixels - i);
+}
+#endif
+
+// rows filtered per task when downsampling on a thread pool
+constexpr unsigned int downsample_band = 32;
+
+const std::array<float, 256>& srgb_to_linear_table() {
+  static const auto table = []() {
+    std::array<float, 256> table;
+    for (int i = 0; i < 256; ++i) {
+      float c = i / 255.0f;
+      table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return table;
+  }();
+  return table;
+}
+
+// indexed by the linear value quantized to 12 bits, fine enough to round trip every 8 bit sRGB value
+const std::array<std::uint8_t, 4096>& linear_to_srgb_table() {
+  static const auto table = []() {
+    std::array<std::uint8_t, 4096> table;
+    for (int i = 0; i < 4096; ++i) {
+      float c = i / 4095.0f;
+      float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+      table[i] = static_cast<std::uint8_t>(std::lround(std::min(1.0f, s) * 255.0f));
+    }
+    return table;
+  }();
+  return table;
+}
+
+// the sRGB encoded channels, a last channel that is alpha stays linear
+unsigned int srgb_channels(unsigned int channels) {
+  return channels >= 3 ? 3 : 1;
+}
+
+// whole rows of linear channels as one flat array, SSE2 converts 16 values per iteration
+void decode_linear(const std::uint8_t* source, float* destination, std::size_t count) {
+  std::size_t i = 0;
+#ifdef BROOM_IMAGE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 max = _mm_set1_ps(255.0f);
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+    __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    // divided rather than multiplied by the reciprocal to match the scalar loop
+    _mm_storeu_ps(destination + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), max));
+    _mm_storeu_ps(destination + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), max));
+    _mm_storeu_ps(destination + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), max));
+    _mm_storeu_ps(destination + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), max));
+  }
+#endif
+  for (; i < count; ++i) {
+    destination[i] = source[i] / 255.0f;
+  }
+}
+
+void encode_linear(const float* source, std::uint8_t* destination, std::size_t count) {
+  std::size_t i = 0;
+#ifdef BROOM_IMAGE_SSE2
+  const __m128 max = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  auto convert = [&](const float* values) {
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(values), max), half));
+  };
+  for (; i + 16 <= count; i += 16) {
+    __m128i low = _mm_packs_epi32(convert(source + i), convert(source + i + 4));
+    __m128i high = _mm_packs_epi32(convert(source + i + 8), convert(source + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(low, high));
+  }
+#endif
+  for (; i < count; ++i) {
+    destination[i] = static_cast<std::uint8_t>(source[i] * 255.0f + 0.5f);
+  }
+}
+
+// the first color_channels channels of each pixel are sRGB encoded, 0 decodes everything as linear.
+// sRGB goes through lookup tables, SSE2 has no gather and the loads cost about as much as the scalar loop.
+void decode_row(const std::uint8_t* source,
+                float* destination,
+                unsigned int width,
+                unsigned int channels,
+                unsigned int color_channels) {
+  if (color_channels == 0) {
+    decode_linear(source, destination, std::size_t{width} * channels);
+    return;
+  }
+  const auto& table = srgb_to_linear_table();
+  for (unsigned int x = 0; x < width; ++x) {
+    for (unsigned int c = 0; c < channels; ++c) {
+      auto value = source[x * channels + c];
+      destination[x * channels + c] = c < color_channels ? table[value] : value / 255.0f;
+    }
+  }
+}
+
+void encode_row(const float* source,
+                std::uint8_t* destination,
+                unsigned int width,
+                unsigned int channels,
+                unsigned int color_channels) {
+  if (color_channels == 0) {
+    encode_linear(source, destination, std::size_t{width} * channels);
+    return;
+  }
+  const auto& table = linear_to_srgb_table();
+  for (unsigned int x = 0; x < width; ++x) {
+    for (unsigned int c = 0; c < channels; ++c) {
+      auto value = source[x * channels + c];
+      destination[x * channels + c] = c < color_channels ? table[static_cast<int>(value * 4095.0f + 0.5f)]
+                                                         : static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+    }
+  }
+}
+
+// averages 2x2 pixels of the two source rows, a source width of 1 repeats the only column
+void filter_row(const float* top,
+                const float* bottom,
+                float* destination,
+                unsigned int source_width,
+                unsigned int width,
+                unsigned int channels) {
+  unsigned int next = source_width > 1 ? channels : 0;
+#ifdef BROOM_IMAGE_SSE2
+  if (channels == 4) {
+    // one RGBA pixel per register
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    for (unsigned int x = 0; x < width; ++x) {
+      const float* t = top + 8 * x;
+      const float* b = bottom + 8 * x;
+      __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(t), _mm_loadu_ps(t + next)),
+                              _mm_add_ps(_mm_loadu_ps(b), _mm_loadu_ps(b + next)));
+      _mm_storeu_ps(destination + 4 * x, _mm_mul_ps(sum, quarter));
+    }
+    return;
+  }
+#endif
+  for (unsigned int x = 0; x < width; ++x) {
+    const float* t = top + 2 * x * channels;
+    const float* b = bottom + 2 * x * channels;
+    for (unsigned int c = 0; c < channels; ++c) {
+      destination[x * channels + c] = 0.25f * (t[c] + t[c + next] + b[c] + b[c + next]);
+    }
+  }
+}
+
+}  // namespace
+
+Image::Image() : _width{0}, _height{0}, _channels{0} {}
+
+Image::Image(unsigned int width, unsigned int height, unsigned int channels)
+    : _width{width}, _height{height}, _channels{channels}, _pixels(std::size_t{width} * height * channels) {}
+
+Image Image::load_from_file(const std::string& filename, bool expand_to_rgba) {
+  // stbi's flip setting is global, so flipping is done here to keep decoding thread safe
+  int width, height, num_channels;
+  unsigned char* data = stbi_load(filename.c_str(), &width, &height, &num_channels, 0);
+
+  if (nullptr == data) {
+    spdlog::error("Failed to load image from file '{}': {}", filename, stbi_failure_reason());
+    throw std::runtime_error("Failed to load image from file \"" + filename + "\"");
+  }
+
+  Image image;
+  image._width = width;
+  image._height = height;
+  if (expand_to_rgba && num_channels == 3) {
+    image._channels = 4;
+    image._pixels.resize(std::size_t{image._width} * image._height * 4);
+    expand_rgb_to_rgba(data, image._pixels.data(), std::size_t{image._width} * image._height);
+  } else {
+    image._channels = num_channels;
+    image._pixels.assign(data, data + std::size_t{image._width} * image._height * num_channels);
+  }
+  stbi_image_free(data);
+
+  image.flip_vertically();
+  return image;
+}
+
+unsigned int Image::width() const {
+  return _width;
+}
+
+unsigned int Image::height() const {
+  return _height;
+}
+
+unsigned int Image::channels() const {
+  return _channels;
+}
+
+std::size_t Image::row_size() const {
+  return std::size_t{_width} * _channels;
+}
+
+const std::vector<std::uint8_t>& Image::pixels() const {
+  return _pixels;
+}
+
+std::vector<std::uint8_t>& Image::pixels() {
+  return _pixels;
+}
+
+GLenum Image::format() const {
+  switch (_channels) {
+    case 1:
+      return GL_RED;
+    case 2:
+      return GL_RG;
+    case 3:
+      return GL_RGB;
+  }
+  return GL_RGBA;
+}
+
+GLenum Image::internal_format() const {
+  switch (_channels) {
+    case 1:
+      return GL_R8;
+    case 2:
+      return GL_RG8;
+    case 3:
+      return GL_RGB8;
+  }
+  return GL_RGBA8;
+}
+
+void Image::flip_vertically() {
+  flip_rows(_pixels.data(), row_size(), _height);
+}
+
+void Image::expand_to_rgba() {
+  if (_channels != 3) {
+    return;
+  }
+  std::vector<std::uint8_t> expanded(std::size_t{_width} * _height * 4);
+  expand_rgb_to_rgba(_pixels.data(), expanded.data(), std::size_t{_width} * _height);
+  _pixels = std::move(expanded);
+  _channels = 4;
+}
+
+Image Image::downsample(bool srgb, ThreadPool* pool) const {
+  Image result{std::max(1u, _width / 2), std::max(1u, _height / 2), _channels};
+  if (nullptr == pool || result._height <= downsample_band) {
+    downsample_rows(result, srgb, 0, result._height);
+    return result;
+  }
+
+  std::vector<std::future<void>> bands;
+  for (unsigned int first = 0; first < result._height; first += downsample_band) {
+    auto last = std::min(result._height, first + downsample_band);
+    bands.push_back(pool->submit([this, &result, srgb, first, last]() { downsample_rows(result, srgb, first, last); }));
+  }
+  for (auto& band : bands) {
+    pool->wait(band);
+  }
+  return result;
+}
+
+std::vector<Image> Image::mip_chain(bool srgb, ThreadPool* pool) const {
+  std::vector<Image> levels;
+  levels.reserve(mip_levels(_width, _height));
+  levels.push_back(*this);
+  while (levels.back()._width > 1 || levels.back()._height > 1) {
+    levels.push_back(levels.back().downsample(srgb, pool));
+  }
+  return levels;
+}
+
+unsigned int Image::mip_levels(unsigned int width, unsigned int height) {
+  unsigned int levels = 1;
+  for (auto size = std::max(width, height); size > 1; size /= 2) {
+    ++levels;
+  }
+  return levels;
+}
+
+void Image::downsample_rows(Image& result, bool srgb, unsigned int first, unsigned int last) const {
+  auto color_channels = srgb ? srgb_channels(_channels) : 0;
+  std::vector<float> top(row_size());
+  std::vector<float> bottom(row_size());
+  std::vector<float> filtered(result.row_size());
+  for (unsigned int y = first; y < last; ++y) {
+    // an odd last row or column is dropped, a single one is repeated
+    auto top_row = std::min(2 * y, _height - 1);
+    auto bottom_row = std::min(2 * y + 1, _height - 1);
+    decode_row(&_pixels[top_row * row_size()], top.data(), _width, _channels, color_channels);
+    decode_row(&_pixels[bottom_row * row_size()], bottom.data(), _width, _channels, color_channels);
+    filter_row(top.data(), bottom.data(), filtered.data(), _width, result._width, _channels);
+    encode_row(filtered.data(), &result._pixels[y * result.row_size()], result._width, _channels, color_channels);
+  }
+}
+
+void flip_rows(std::uint8_t* pixels, std::size_t row_size, std::size_t rows) {
+  // swaps in place, without a temporary row
+  for (std::size_t top = 0, bottom = rows; top + 1 < bottom; ++top) {
+    --bottom;
+    std::swap_ranges(pixels + top * row_size, pixels + (top + 1) * row_size, pixels + bottom * row_size);
+  }
+}
+
+void expand_rgb_to_rgba(const std::uint8_t* source, std::uint8_t* destination, std::size_t pixels) {
+#ifdef BROOM_IMAGE_SSSE3
+  static const bool ssse3 = __builtin_cpu_supports("ssse3");
+  if (ssse3) {
+    expand_rgb_to_rgba_ssse3(source, destination, pixels);
+    return;
+  }
+#endif
+  expand_rgb_to_rgba_scalar(source, destination, pixels);
+}
+
+}  // namespace broom
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+#include <broom/thread_pool.hpp>
+
+namespace broom {
+
+// Tightly packed 8 bit pixels decoded on the CPU, safe to load on any thread.
+class Image {
+ public:
+  Image();
+  Image(unsigned int width, unsigned int height, unsigned int channels);
+
+  // rows are flipped so that the first one is the bottom of the image, as GL expects it
+  static Image load_from_file(const std::string& filename, bool expand_to_rgba = false);
+
+  unsigned int width() const;
+  unsigned int height() const;
+  unsigned int channels() const;
+  std::size_t row_size() const;
+  const std::vector<std::uint8_t>& pixels() const;
+  std::vector<std::uint8_t>& pixels();
+
+  GLenum format() const;
+  GLenum internal_format() const;
+
+  void flip_vertically();
+  // no-op for images that are not RGB
+  void expand_to_rgba();
+
+  // half the size with a 2x2 box filter, averaged in linear space if the color channels are sRGB encoded.
+  // Those are RGB, or the first channel of grey and grey+alpha images, alpha stays linear. Pass srgb = false
+  // for linear data such as masks, normals or heights. With a pool, bands of rows are filtered in parallel,
+  // which also works from a task running on that same pool.
+  Image downsample(bool srgb = true, ThreadPool* pool = nullptr) const;
+  // this image followed by all smaller levels down to 1x1
+  std::vector<Image> mip_chain(bool srgb = true, ThreadPool* pool = nullptr) const;
+  static unsigned int mip_levels(unsigned int width, unsigned int height);
+
+ protected:
+  void downsample_rows(Image& result, bool srgb, unsigned int first, unsigned int last) const;
+
+ protected:
+  unsigned int _width;
+  unsigned int _height;
+  unsigned int _channels;
+  std::vector<std::uint8_t> _pixels;
+};
+
+void flip_rows(std::uint8_t* pixels, std::size_t row_size, std::size_t rows);
+// destination holds 4 bytes per pixel and may not alias the source
+void expand_rgb_to_rgba(const std::uint8_t* source, std::uint8_t* destination, std::size_t pixels);
+
+}  // namespace broom
@@ -0,0 +1,113 @@
+#include <broom/indirect_command_buffer.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace broom {
+
+IndirectCommandBuffer::IndirectCommandBuffer(GLenum mode,
+                                             GLenum index_type,
+                                             GLsizeiptr per_draw_size,
+                                             GLuint per_draw_binding)
+    : _mode{mode}, _index_type{index_type}, _per_draw_size{per_draw_size}, _per_draw_binding{per_draw_binding} {
+  GLint alignment = 1;
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  _storage_alignment = std::max<GLint>(alignment, 1);
+}
+
+std::size_t IndirectCommandBuffer::size() const {
+  return _entries.size();
+}
+
+std::size_t IndirectCommandBuffer::bucket_count() const {
+  return _buckets.size();
+}
+
+const Buffer& IndirectCommandBuffer::buffer() const {
+  return _commands;
+}
+
+const Buffer& IndirectCommandBuffer::per_draw_buffer() const {
+  return _per_draw_data;
+}
+
+GLintptr IndirectCommandBuffer::command_offset(std::size_t index) const {
+  return _command_offsets.at(index);
+}
+
+void IndirectCommandBuffer::append(GLuint program, GLuint vertex_array, const DrawElementsIndirectCommand& command) {
+  _entries.push_back(Entry{program, vertex_array, command});
+  _per_draw.resize(_per_draw.size() + _per_draw_size);
+}
+
+void IndirectCommandBuffer::clear() {
+  _entries.clear();
+  _per_draw.clear();
+  _buckets.clear();
+  _command_offsets.clear();
+}
+
+void IndirectCommandBuffer::upload() {
+  _buckets.clear();
+  auto count = _entries.size();
+  if (count == 0) {
+    return;
+  }
+
+  _order.resize(count);
+  std::iota(_order.begin(), _order.end(), 0);
+  std::stable_sort(_order.begin(), _order.end(), [this](std::uint32_t lhs, std::uint32_t rhs) {
+    const auto& a = _entries[lhs];
+    const auto& b = _entries[rhs];
+    return a.program < b.program || (a.program == b.program && a.vertex_array < b.vertex_array);
+  });
+
+  _commands_staging.resize(count);
+  _command_offsets.resize(count);
+  _per_draw_staging.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto& entry = _entries[_order[i]];
+    if (_buckets.empty() || _buckets.back().program != entry.program ||
+        _buckets.back().vertex_array != entry.vertex_array) {
+      // every bucket's per-draw array starts at a bindable offset, gl_DrawIDARB restarts at 0 for each multi-draw
+      auto per_draw_offset =
+          (static_cast<GLintptr>(_per_draw_staging.size()) + _storage_alignment - 1) / _storage_alignment *
+          _storage_alignment;
+      _per_draw_staging.resize(per_draw_offset);
+      _buckets.push_back(Bucket{entry.program, entry.vertex_array, 0,
+                                static_cast<GLintptr>(i * sizeof(DrawElementsIndirectCommand)), per_draw_offset});
+    }
+    ++_buckets.back().draw_count;
+    _commands_staging[i] = entry.command;
+    _command_offsets[_order[i]] = static_cast<GLintptr>(i * sizeof(DrawElementsIndirectCommand));
+    if (_per_draw_size > 0) {
+      auto source = _per_draw.begin() + _order[i] * _per_draw_size;
+      _per_draw_staging.insert(_per_draw_staging.end(), source, source + _per_draw_size);
+    }
+  }
+
+  _commands.set_data(count * sizeof(DrawElementsIndirectCommand), _commands_staging.data(), GL_DYNAMIC_DRAW);
+  if (_per_draw_size > 0) {
+    _per_draw_data.set_data(_per_draw_staging.size(), _per_draw_staging.data(), GL_DYNAMIC_DRAW);
+  }
+}
+
+void IndirectCommandBuffer::submit() const {
+  if (_buckets.empty()) {
+    return;
+  }
+
+  auto& state = StateCache::current();
+  _commands.bind(GL_DRAW_INDIRECT_BUFFER);
+  for (const auto& bucket : _buckets) {
+    state.use_program(bucket.program);
+    state.bind_vertex_array(bucket.vertex_array);
+    if (_per_draw_size > 0) {
+      _per_draw_data.bind_range(GL_SHADER_STORAGE_BUFFER, _per_draw_binding, bucket.per_draw_offset,
+                                bucket.draw_count * _per_draw_size);
+    }
+    multi_draw_elements_indirect(_mode, _index_type, bucket.command_offset, bucket.draw_count);
+  }
+}
+
+}  // namespace broom
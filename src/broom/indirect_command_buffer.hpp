@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/buffer.hpp>
+#include <broom/draw.hpp>
+#include <broom/opengl.hpp>
+#include <broom/state_cache.hpp>
+
+namespace broom {
+
+// Collects indexed draws and submits them with one glMultiDrawElementsIndirect per program and vertex array.
+//
+// Optional per-draw data of a fixed size is bound as a shader storage buffer, one array per bucket, so that
+// shaders can look it up with the draw index of the multi-draw:
+//
+//   #extension GL_ARB_shader_draw_parameters : require
+//   layout(std430, binding = 0) readonly buffer PerDraw { DrawData draws[]; };
+//   ... draws[gl_DrawIDARB] ...
+//
+// After upload() the commands may also be rewritten on the GPU, e.g. by a culling compute shader that binds
+// buffer() as a storage buffer and sets instance_count to 0; command_offset() gives a draw's byte offset.
+class IndirectCommandBuffer {
+ public:
+  IndirectCommandBuffer(GLenum mode = GL_TRIANGLES,
+                        GLenum index_type = GL_UNSIGNED_INT,
+                        GLsizeiptr per_draw_size = 0,
+                        GLuint per_draw_binding = 0);
+  IndirectCommandBuffer(const IndirectCommandBuffer&) = delete;
+  IndirectCommandBuffer(IndirectCommandBuffer&&) = delete;
+
+  IndirectCommandBuffer& operator=(const IndirectCommandBuffer& other) = delete;
+  IndirectCommandBuffer& operator=(IndirectCommandBuffer&& other) = delete;
+
+  std::size_t size() const;
+  std::size_t bucket_count() const;
+  const Buffer& buffer() const;
+  const Buffer& per_draw_buffer() const;
+  // byte offset of the i-th appended draw in buffer(), valid after upload()
+  GLintptr command_offset(std::size_t index) const;
+
+  void append(GLuint program, GLuint vertex_array, const DrawElementsIndirectCommand& command);
+  template <typename T>
+  void append(GLuint program, GLuint vertex_array, const DrawElementsIndirectCommand& command, const T& per_draw) {
+    static_assert(std::is_trivially_copyable<T>::value, "per-draw data is copied bytewise");
+    if (sizeof(T) != static_cast<std::size_t>(_per_draw_size)) {
+      throw std::runtime_error("Per-draw data does not match the size of the indirect command buffer");
+    }
+    append(program, vertex_array, command);
+    std::memcpy(&_per_draw[(_entries.size() - 1) * _per_draw_size], &per_draw, sizeof(T));
+  }
+  void clear();
+
+  // sorts the draws into buckets and copies commands and per-draw data into the GL buffers
+  void upload();
+  // one multi-draw per bucket, upload() has to be called whenever draws were appended
+  void submit() const;
+
+ protected:
+  struct Entry {
+    GLuint program;
+    GLuint vertex_array;
+    DrawElementsIndirectCommand command;
+  };
+
+  struct Bucket {
+    GLuint program;
+    GLuint vertex_array;
+    GLsizei draw_count;
+    GLintptr command_offset;
+    GLintptr per_draw_offset;
+  };
+
+ protected:
+  GLenum _mode;
+  GLenum _index_type;
+  GLsizeiptr _per_draw_size;
+  GLuint _per_draw_binding;
+  GLintptr _storage_alignment;
+
+  std::vector<Entry> _entries;
+  std::vector<std::uint8_t> _per_draw;
+  std::vector<Bucket> _buckets;
+  std::vector<std::uint32_t> _order;
+  std::vector<GLintptr> _command_offsets;
+
+  // staging copies, kept to avoid allocations per upload
+  std::vector<DrawElementsIndirectCommand> _commands_staging;
+  std::vector<std::uint8_t> _per_draw_staging;
+
+  Buffer _commands;
+  Buffer _per_draw_data;
+};
+
+}  // namespace broom
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// What the commands after a barrier read that shaders wrote through image stores, storage buffers or atomic
+// counters before it, named after the GL_*_BARRIER_BIT they stand for.
+enum class Barrier : GLbitfield {
+  vertex_attrib_array = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+  element_array = GL_ELEMENT_ARRAY_BARRIER_BIT,
+  uniform = GL_UNIFORM_BARRIER_BIT,
+  texture_fetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+  shader_image_access = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+  command = GL_COMMAND_BARRIER_BIT,
+  pixel_buffer = GL_PIXEL_BUFFER_BARRIER_BIT,
+  texture_update = GL_TEXTURE_UPDATE_BARRIER_BIT,
+  buffer_update = GL_BUFFER_UPDATE_BARRIER_BIT,
+  client_mapped_buffer = GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT,
+  query_buffer = GL_QUERY_BUFFER_BARRIER_BIT,
+  framebuffer = GL_FRAMEBUFFER_BARRIER_BIT,
+  transform_feedback = GL_TRANSFORM_FEEDBACK_BARRIER_BIT,
+  atomic_counter = GL_ATOMIC_COUNTER_BARRIER_BIT,
+  shader_storage = GL_SHADER_STORAGE_BARRIER_BIT,
+  all = GL_ALL_BARRIER_BITS,
+};
+
+constexpr Barrier operator|(Barrier lhs, Barrier rhs) {
+  return static_cast<Barrier>(static_cast<GLbitfield>(lhs) | static_cast<GLbitfield>(rhs));
+}
+
+// e.g. memory_barrier(Barrier::shader_storage | Barrier::vertex_attrib_array) after a compute pass that
+// writes vertices for the following draws
+inline void memory_barrier(Barrier barriers) {
+  glMemoryBarrier(static_cast<GLbitfield>(barriers));
+}
+
+// only orders the fragments of the same framebuffer region, for fragment shaders reading what earlier
+// fragment shaders stored
+inline void memory_barrier_by_region(Barrier barriers) {
+  glMemoryBarrierByRegion(static_cast<GLbitfield>(barriers));
+}
+
+}  // namespace broom
@@ -0,0 +1,76 @@
+#include <broom/mesh.hpp>
+
+#include <vector>
+
+#include <broom/draw.hpp>
+#include <broom/mesh_import.hpp>
+#include <broom/mesh_optimizer.hpp>
+
+namespace broom {
+
+Mesh::Mesh(const MeshData& data)
+    : _vertex_count{static_cast<GLsizei>(data.vertices.size())},
+      _index_count{static_cast<GLsizei>(data.indices.size())},
+      // 16 bit indices address up to 65536 vertices
+      _index_type{data.vertices.size() <= 65536 ? GLenum{GL_UNSIGNED_SHORT} : GLenum{GL_UNSIGNED_INT}} {
+  if (data.vertices.empty() || data.indices.empty()) {
+    throw std::runtime_error("Failed to create mesh without triangles");
+  }
+
+  std::vector<Vertex> vertices(data.vertices.size());
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    const auto& vertex = data.vertices[i];
+    vertices[i] = Vertex{vertex.position, pack_normal(vertex.normal), pack_half(vertex.tex_coord)};
+  }
+  _vertex_buffer.set_storage(vertices);
+
+  if (_index_type == GL_UNSIGNED_SHORT) {
+    _index_buffer.set_storage(std::vector<std::uint16_t>(data.indices.begin(), data.indices.end()));
+  } else {
+    _index_buffer.set_storage(data.indices);
+  }
+
+  _vertex_array.set_vertex_buffer(0, _vertex_buffer, Layout::format());
+  _vertex_array.set_element_buffer(_index_buffer);
+  spdlog::debug("Created mesh with {} vertices and {} {} bit indices", _vertex_count, _index_count,
+                _index_type == GL_UNSIGNED_SHORT ? 16 : 32);
+}
+
+std::unique_ptr<Mesh> Mesh::load_from_file(const std::string& filename, bool optimize) {
+  auto data = load_mesh_data(filename);
+  if (optimize) {
+    optimize_mesh(data);
+  }
+  return std::make_unique<Mesh>(data);
+}
+
+const Buffer& Mesh::vertex_buffer() const {
+  return _vertex_buffer;
+}
+
+const Buffer& Mesh::index_buffer() const {
+  return _index_buffer;
+}
+
+const VertexArray& Mesh::vertex_array() const {
+  return _vertex_array;
+}
+
+GLsizei Mesh::vertex_count() const {
+  return _vertex_count;
+}
+
+GLsizei Mesh::index_count() const {
+  return _index_count;
+}
+
+GLenum Mesh::index_type() const {
+  return _index_type;
+}
+
+void Mesh::draw() const {
+  _vertex_array.bind();
+  draw_elements(GL_TRIANGLES, _index_count, _index_type);
+}
+
+}  // namespace broom
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/buffer.hpp>
+#include <broom/mesh_data.hpp>
+#include <broom/opengl.hpp>
+#include <broom/vertex_array.hpp>
+#include <broom/vertex_compression.hpp>
+#include <broom/vertex_layout.hpp>
+
+namespace broom {
+
+// Triangles on the GPU, a vertex buffer, an index buffer and the vertex array reading them.
+//
+// Vertices keep float positions and pack normals into 2_10_10_10 and texture coordinates into halves,
+// 20 instead of 32 bytes. Shaders read them as vec3 in_position, vec3 in_normal and vec2 in_tex_coord at
+// locations 0, 1 and 2. Indices are 16 bit if every vertex can be addressed with them.
+class Mesh {
+ public:
+  struct Vertex {
+    glm::vec3 position;
+    PackedNormal normal;
+    PackedHalf<2> tex_coord;
+  };
+  using Layout = VertexLayout<VertexAttribute<0, &Vertex::position>,
+                              VertexAttribute<1, &Vertex::normal>,
+                              VertexAttribute<2, &Vertex::tex_coord>>;
+
+  explicit Mesh(const MeshData& data);
+  Mesh(const Mesh&) = delete;
+  Mesh(Mesh&&) = delete;
+
+  Mesh& operator=(const Mesh& other) = delete;
+  Mesh& operator=(Mesh&& other) = delete;
+
+  // OBJ, glTF or GLB, optimized for the vertex cache, overdraw and vertex fetch unless told otherwise
+  static std::unique_ptr<Mesh> load_from_file(const std::string& filename, bool optimize = true);
+
+  const Buffer& vertex_buffer() const;
+  const Buffer& index_buffer() const;
+  const VertexArray& vertex_array() const;
+  GLsizei vertex_count() const;
+  GLsizei index_count() const;
+  GLenum index_type() const;
+
+  // binds the vertex array and draws all triangles with the current program
+  void draw() const;
+
+ protected:
+  Buffer _vertex_buffer;
+  Buffer _index_buffer;
+  VertexArray _vertex_array;
+  GLsizei _vertex_count;
+  GLsizei _index_count;
+  GLenum _index_type;
+};
+
+}  // namespace broom
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// texture coordinates have their origin at the bottom left, as GL samples images loaded through Image
+struct MeshVertex {
+  glm::vec3 position;
+  glm::vec3 normal;
+  glm::vec2 tex_coord;
+};
+
+// Triangles on the CPU, as loaded from a file and before they are optimized and uploaded.
+struct MeshData {
+  std::vector<MeshVertex> vertices;
+  std::vector<std::uint32_t> indices;
+};
+
+}  // namespace broom
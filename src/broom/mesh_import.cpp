@@ -0,0 +1,761 @@
+#include <broom/mesh_import.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <broom/hash.hpp>
+
+namespace broom {
+
+namespace {
+
+std::string read_file(const std::string& filename) {
+  std::ifstream file{filename, std::ios::binary};
+  if (!file.is_open()) {
+    spdlog::error("Failed to open file \"{}\"", filename);
+    throw std::runtime_error("Failed to open mesh file \"" + filename + "\"");
+  }
+  return std::string{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+bool ends_with(const std::string& string, std::string_view ending) {
+  return string.size() >= ending.size() && string.compare(string.size() - ending.size(), ending.size(), ending) == 0;
+}
+
+// bitwise, so that -0 and 0 stay apart like they do in the hash
+struct PositionHash {
+  std::size_t operator()(const glm::vec3& position) const {
+    return fnv1a(std::string_view{reinterpret_cast<const char*>(&position), sizeof(position)});
+  }
+};
+
+struct PositionEqual {
+  bool operator()(const glm::vec3& lhs, const glm::vec3& rhs) const {
+    return std::memcmp(&lhs, &rhs, sizeof(glm::vec3)) == 0;
+  }
+};
+
+// 1 based, negative indices count back from the last element read so far, returns 0 if there is none
+std::size_t parse_obj_index(const char*& p, std::size_t count, const std::string& filename) {
+  char* end;
+  long index = std::strtol(p, &end, 10);
+  if (end == p) {
+    return 0;
+  }
+  p = end;
+  if (index < 0) {
+    index += static_cast<long>(count) + 1;
+  }
+  if (index <= 0 || static_cast<std::size_t>(index) > count) {
+    throw std::runtime_error("Face refers to a missing element in OBJ file \"" + filename + "\"");
+  }
+  return static_cast<std::size_t>(index);
+}
+
+template <glm::length_t L>
+glm::vec<L, float> parse_obj_vector(const char* p) {
+  glm::vec<L, float> result{0.0f};
+  for (glm::length_t i = 0; i < L; ++i) {
+    char* end;
+    result[i] = std::strtof(p, &end);
+    p = end;
+  }
+  return result;
+}
+
+// the subset of JSON values glTF needs, members keep their order
+struct Json {
+  enum class Type { null, boolean, number, string, array, object };
+
+  Type type = Type::null;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<Json> array;
+  std::vector<std::pair<std::string, Json>> object;
+
+  // a null value for missing members and elements
+  const Json& operator[](std::string_view key) const;
+  const Json& operator[](std::size_t index) const;
+
+  bool is_null() const { return type == Type::null; }
+  double number_or(double fallback) const { return type == Type::number ? number : fallback; }
+  // integers from 0 to 2^53, which a double holds exactly and converting to size_t is defined for
+  bool is_size() const {
+    return type == Type::number && number >= 0.0 && number <= 9007199254740992.0 && std::floor(number) == number;
+  }
+};
+
+const Json& null_json() {
+  static const Json null;
+  return null;
+}
+
+const Json& Json::operator[](std::string_view key) const {
+  for (const auto& member : object) {
+    if (member.first == key) {
+      return member.second;
+    }
+  }
+  return null_json();
+}
+
+const Json& Json::operator[](std::size_t index) const {
+  return index < array.size() ? array[index] : null_json();
+}
+
+class JsonParser {
+ public:
+  JsonParser(std::string_view text) : _text{text}, _position{0}, _depth{0} {}
+
+  Json parse() {
+    auto value = parse_value();
+    skip_whitespace();
+    if (_position != _text.size()) {
+      fail("unexpected characters after the value");
+    }
+    return value;
+  }
+
+ protected:
+  [[noreturn]] void fail(const char* reason) const {
+    throw std::runtime_error("Invalid JSON at offset " + std::to_string(_position) + ": " + reason);
+  }
+
+  char peek() const { return _position < _text.size() ? _text[_position] : '\0'; }
+
+  void skip_whitespace() {
+    while (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r') {
+      ++_position;
+    }
+  }
+
+  bool consume(char c) {
+    skip_whitespace();
+    if (peek() != c) {
+      return false;
+    }
+    ++_position;
+    return true;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) {
+      fail("unexpected character");
+    }
+  }
+
+  void expect_literal(std::string_view literal) {
+    if (_text.substr(_position, literal.size()) != literal) {
+      fail("unknown literal");
+    }
+    _position += literal.size();
+  }
+
+  Json parse_value() {
+    // deeply nested input would otherwise overflow the stack
+    if (++_depth > 256) {
+      fail("nested too deeply");
+    }
+    Json value;
+    skip_whitespace();
+    switch (peek()) {
+      case '{':
+        ++_position;
+        value.type = Json::Type::object;
+        if (!consume('}')) {
+          do {
+            skip_whitespace();
+            auto key = parse_string();
+            expect(':');
+            value.object.emplace_back(std::move(key), parse_value());
+          } while (consume(','));
+          expect('}');
+        }
+        break;
+      case '[':
+        ++_position;
+        value.type = Json::Type::array;
+        if (!consume(']')) {
+          do {
+            value.array.push_back(parse_value());
+          } while (consume(','));
+          expect(']');
+        }
+        break;
+      case '"':
+        value.type = Json::Type::string;
+        value.string = parse_string();
+        break;
+      case 't':
+        expect_literal("true");
+        value.type = Json::Type::boolean;
+        value.boolean = true;
+        break;
+      case 'f':
+        expect_literal("false");
+        value.type = Json::Type::boolean;
+        break;
+      case 'n':
+        expect_literal("null");
+        break;
+      default:
+        value.type = Json::Type::number;
+        value.number = parse_number();
+        break;
+    }
+    --_depth;
+    return value;
+  }
+
+  std::string parse_string() {
+    if (peek() != '"') {
+      fail("expected a string");
+    }
+    ++_position;
+    std::string result;
+    while (true) {
+      if (_position >= _text.size()) {
+        fail("unterminated string");
+      }
+      char c = _text[_position++];
+      if (c == '"') {
+        return result;
+      }
+      if (c != '\\') {
+        result += c;
+        continue;
+      }
+      switch (peek()) {
+        case '"':
+        case '\\':
+        case '/':
+          result += _text[_position];
+          break;
+        case 'b':
+          result += '\b';
+          break;
+        case 'f':
+          result += '\f';
+          break;
+        case 'n':
+          result += '\n';
+          break;
+        case 'r':
+          result += '\r';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case 'u': {
+          ++_position;
+          auto code = parse_hex4();
+          // a high surrogate is followed by the escaped low one
+          if (code >= 0xd800 && code < 0xdc00 && _text.substr(_position, 2) == "\\u") {
+            _position += 2;
+            auto low = parse_hex4();
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+          }
+          append_utf8(result, code);
+          continue;
+        }
+        default:
+          fail("unknown escape sequence");
+      }
+      ++_position;
+    }
+  }
+
+  std::uint32_t parse_hex4() {
+    if (_position + 4 > _text.size()) {
+      fail("truncated unicode escape");
+    }
+    std::uint32_t code = 0;
+    for (int i = 0; i < 4; ++i) {
+      char c = _text[_position++];
+      code <<= 4;
+      if (c >= '0' && c <= '9') {
+        code |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        code |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        code |= c - 'A' + 10;
+      } else {
+        fail("invalid unicode escape");
+      }
+    }
+    return code;
+  }
+
+  static void append_utf8(std::string& string, std::uint32_t code) {
+    if (code < 0x80) {
+      string += static_cast<char>(code);
+    } else if (code < 0x800) {
+      string += static_cast<char>(0xc0 | code >> 6);
+      string += static_cast<char>(0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+      string += static_cast<char>(0xe0 | code >> 12);
+      string += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+      string += static_cast<char>(0x80 | (code & 0x3f));
+    } else {
+      string += static_cast<char>(0xf0 | code >> 18);
+      string += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+      string += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+      string += static_cast<char>(0x80 | (code & 0x3f));
+    }
+  }
+
+  double parse_number() {
+    auto start = _position;
+    while (_position < _text.size() && std::strchr("+-.0123456789eE", _text[_position]) != nullptr) {
+      ++_position;
+    }
+    // strtod needs a terminated string
+    std::string number{_text.substr(start, _position - start)};
+    char* end;
+    double value = std::strtod(number.c_str(), &end);
+    if (number.empty() || end != number.c_str() + number.size()) {
+      _position = start;
+      fail("invalid number");
+    }
+    return value;
+  }
+
+ protected:
+  std::string_view _text;
+  std::size_t _position;
+  unsigned int _depth;
+};
+
+std::string decode_base64(std::string_view encoded, const std::string& filename) {
+  auto value = [](char c) -> int {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  };
+  std::string result;
+  result.reserve(encoded.size() / 4 * 3);
+  std::uint32_t bits = 0;
+  int count = 0;
+  for (char c : encoded) {
+    if (c == '=') {
+      break;
+    }
+    int v = value(c);
+    if (v < 0) {
+      throw std::runtime_error("Invalid base64 data in glTF file \"" + filename + "\"");
+    }
+    bits = bits << 6 | static_cast<std::uint32_t>(v);
+    count += 6;
+    if (count >= 8) {
+      count -= 8;
+      result += static_cast<char>(bits >> count & 0xff);
+    }
+  }
+  return result;
+}
+
+struct GltfAccessor {
+  const std::uint8_t* data;
+  std::size_t count;
+  std::size_t stride;
+  GLenum component_type;
+  std::size_t components;
+  bool normalized;
+};
+
+std::size_t component_size(GLenum type) {
+  switch (type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+      return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+      return 2;
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+GltfAccessor gltf_accessor(const Json& gltf,
+                           const std::vector<std::string>& buffers,
+                           const Json& index,
+                           const std::string& filename) {
+  auto fail = [&](const std::string& reason) {
+    throw std::runtime_error("Invalid accessor in glTF file \"" + filename + "\": " + reason);
+  };
+  // missing members take the fallback, present ones must be sizes
+  auto size = [&](const Json& value, std::size_t fallback, const std::string& name) -> std::size_t {
+    if (value.is_null()) {
+      return fallback;
+    }
+    if (!value.is_size()) {
+      fail(name + " is not a non-negative integer");
+    }
+    return static_cast<std::size_t>(value.number);
+  };
+  auto element = [&](const Json& array, const Json& value, const std::string& name) -> const Json& {
+    if (!value.is_size() || value.number >= array.array.size()) {
+      fail("missing " + name);
+    }
+    return array[static_cast<std::size_t>(value.number)];
+  };
+
+  const auto& accessor = element(gltf["accessors"], index, "accessor");
+  if (!accessor["sparse"].is_null() || accessor["bufferView"].is_null()) {
+    fail("sparse accessors are not supported");
+  }
+
+  GltfAccessor result;
+  const auto& type = accessor["type"].string;
+  result.components = type == "SCALAR" ? 1 : type == "VEC2" ? 2 : type == "VEC3" ? 3 : type == "VEC4" ? 4 : 0;
+  auto component_type = size(accessor["componentType"], 0, "componentType");
+  result.component_type = component_type <= 0xffff ? static_cast<GLenum>(component_type) : GL_NONE;
+  result.count = size(accessor["count"], 0, "count");
+  result.normalized = accessor["normalized"].boolean;
+  std::size_t element_size = result.components * component_size(result.component_type);
+  if (element_size == 0) {
+    fail("unsupported type " + type);
+  }
+
+  const auto& view = element(gltf["bufferViews"], accessor["bufferView"], "buffer view");
+  auto buffer = size(view["buffer"], buffers.size(), "buffer");
+  auto view_offset = size(view["byteOffset"], 0, "byteOffset");
+  auto view_length = size(view["byteLength"], 0, "byteLength");
+  auto offset = size(accessor["byteOffset"], 0, "byteOffset");
+  result.stride = size(view["byteStride"], element_size, "byteStride");
+  // compared by subtracting from sizes already checked, so that crafted values cannot wrap around
+  if (buffer >= buffers.size() || view_offset > buffers[buffer].size() ||
+      view_length > buffers[buffer].size() - view_offset) {
+    fail("buffer view outside of its buffer");
+  }
+  if (result.stride < element_size) {
+    fail("byteStride smaller than an element");
+  }
+  if (result.count > 0 && (offset > view_length || element_size > view_length - offset ||
+                           result.count - 1 > (view_length - offset - element_size) / result.stride)) {
+    fail("elements outside of their buffer view");
+  }
+  result.data = reinterpret_cast<const std::uint8_t*>(buffers[buffer].data()) + view_offset + offset;
+  return result;
+}
+
+float read_component(const std::uint8_t* data, GLenum type, bool normalized) {
+  // normalized signed values are clamped as -128 and -127 both map to -1
+  switch (type) {
+    case GL_BYTE: {
+      auto value = static_cast<float>(static_cast<std::int8_t>(*data));
+      return normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case GL_UNSIGNED_BYTE:
+      return normalized ? *data / 255.0f : *data;
+    case GL_SHORT: {
+      std::int16_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case GL_UNSIGNED_SHORT: {
+      std::uint16_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return normalized ? value / 65535.0f : value;
+    }
+    case GL_UNSIGNED_INT: {
+      std::uint32_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return static_cast<float>(value);
+    }
+    default: {
+      float value;
+      std::memcpy(&value, data, sizeof(value));
+      return value;
+    }
+  }
+}
+
+template <glm::length_t L>
+glm::vec<L, float> read_vector(const GltfAccessor& accessor, std::size_t index) {
+  glm::vec<L, float> result{0.0f};
+  auto size = component_size(accessor.component_type);
+  for (glm::length_t i = 0; i < L && static_cast<std::size_t>(i) < accessor.components; ++i) {
+    result[i] = read_component(accessor.data + index * accessor.stride + i * size, accessor.component_type,
+                               accessor.normalized);
+  }
+  return result;
+}
+
+std::uint32_t read_index(const GltfAccessor& accessor, std::size_t index) {
+  const auto* data = accessor.data + index * accessor.stride;
+  switch (accessor.component_type) {
+    case GL_UNSIGNED_BYTE:
+      return *data;
+    case GL_UNSIGNED_SHORT: {
+      std::uint16_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return value;
+    }
+    default: {
+      std::uint32_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return value;
+    }
+  }
+}
+
+void append(MeshData& mesh, const MeshData& other) {
+  auto base = static_cast<std::uint32_t>(mesh.vertices.size());
+  mesh.vertices.insert(mesh.vertices.end(), other.vertices.begin(), other.vertices.end());
+  for (auto index : other.indices) {
+    mesh.indices.push_back(base + index);
+  }
+}
+
+MeshData load_gltf_primitive(const Json& gltf,
+                             const Json& primitive,
+                             const std::vector<std::string>& buffers,
+                             const std::string& filename) {
+  const auto& attributes = primitive["attributes"];
+  auto positions = gltf_accessor(gltf, buffers, attributes["POSITION"], filename);
+  if (positions.components != 3 || positions.component_type != GL_FLOAT) {
+    throw std::runtime_error("Positions are not VEC3 floats in glTF file \"" + filename + "\"");
+  }
+
+  MeshData mesh;
+  mesh.vertices.resize(positions.count);
+  for (std::size_t i = 0; i < positions.count; ++i) {
+    mesh.vertices[i] = MeshVertex{read_vector<3>(positions, i), glm::vec3{0.0f}, glm::vec2{0.0f}};
+  }
+  if (!attributes["NORMAL"].is_null()) {
+    auto normals = gltf_accessor(gltf, buffers, attributes["NORMAL"], filename);
+    for (std::size_t i = 0; i < positions.count && i < normals.count; ++i) {
+      mesh.vertices[i].normal = read_vector<3>(normals, i);
+    }
+  }
+  if (!attributes["TEXCOORD_0"].is_null()) {
+    auto tex_coords = gltf_accessor(gltf, buffers, attributes["TEXCOORD_0"], filename);
+    for (std::size_t i = 0; i < positions.count && i < tex_coords.count; ++i) {
+      // glTF puts the origin at the top left
+      auto tex_coord = read_vector<2>(tex_coords, i);
+      mesh.vertices[i].tex_coord = glm::vec2{tex_coord.x, 1.0f - tex_coord.y};
+    }
+  }
+
+  if (primitive["indices"].is_null()) {
+    mesh.indices.resize(positions.count - positions.count % 3);
+    for (std::size_t i = 0; i < mesh.indices.size(); ++i) {
+      mesh.indices[i] = static_cast<std::uint32_t>(i);
+    }
+  } else {
+    auto indices = gltf_accessor(gltf, buffers, primitive["indices"], filename);
+    if (indices.components != 1 || indices.component_type == GL_FLOAT || indices.component_type == GL_BYTE ||
+        indices.component_type == GL_SHORT) {
+      throw std::runtime_error("Indices are not unsigned integers in glTF file \"" + filename + "\"");
+    }
+    mesh.indices.resize(indices.count - indices.count % 3);
+    for (std::size_t i = 0; i < mesh.indices.size(); ++i) {
+      mesh.indices[i] = read_index(indices, i);
+      if (mesh.indices[i] >= positions.count) {
+        throw std::runtime_error("Index out of range in glTF file \"" + filename + "\"");
+      }
+    }
+  }
+
+  if (attributes["NORMAL"].is_null()) {
+    generate_normals(mesh);
+  }
+  return mesh;
+}
+
+}  // namespace
+
+MeshData load_obj(const std::string& filename) {
+  std::ifstream file{filename};
+  if (!file.is_open()) {
+    spdlog::error("Failed to open file \"{}\"", filename);
+    throw std::runtime_error("Failed to open mesh file \"" + filename + "\"");
+  }
+
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> tex_coords;
+  std::vector<glm::vec3> normals;
+  MeshData mesh;
+  // corners without a vn get generated normals, the others keep the ones from the file
+  std::vector<std::uint32_t> missing_normals;
+  std::string line;
+  while (std::getline(file, line)) {
+    const char* p = line.c_str();
+    while (*p == ' ' || *p == '\t') {
+      ++p;
+    }
+    if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+      positions.push_back(parse_obj_vector<3>(p + 2));
+    } else if (p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t')) {
+      tex_coords.push_back(parse_obj_vector<2>(p + 3));
+    } else if (p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+      normals.push_back(parse_obj_vector<3>(p + 3));
+    } else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+      // corners are v, v/vt, v//vn or v/vt/vn
+      auto first = static_cast<std::uint32_t>(mesh.vertices.size());
+      ++p;
+      while (true) {
+        while (*p == ' ' || *p == '\t') {
+          ++p;
+        }
+        if (*p == '\0' || *p == '\r' || *p == '#') {
+          break;
+        }
+        MeshVertex vertex{glm::vec3{0.0f}, glm::vec3{0.0f}, glm::vec2{0.0f}};
+        auto position = parse_obj_index(p, positions.size(), filename);
+        if (position == 0) {
+          throw std::runtime_error("Invalid face in OBJ file \"" + filename + "\"");
+        }
+        vertex.position = positions[position - 1];
+        std::size_t normal = 0;
+        if (*p == '/') {
+          ++p;
+          if (auto tex_coord = parse_obj_index(p, tex_coords.size(), filename)) {
+            vertex.tex_coord = tex_coords[tex_coord - 1];
+          }
+          if (*p == '/') {
+            ++p;
+            normal = parse_obj_index(p, normals.size(), filename);
+          }
+        }
+        if (normal > 0) {
+          vertex.normal = normals[normal - 1];
+        } else {
+          missing_normals.push_back(static_cast<std::uint32_t>(mesh.vertices.size()));
+        }
+        mesh.vertices.push_back(vertex);
+      }
+      auto last = static_cast<std::uint32_t>(mesh.vertices.size());
+      for (auto corner = first + 2; corner < last; ++corner) {
+        mesh.indices.insert(mesh.indices.end(), {first, corner - 1, corner});
+      }
+    }
+  }
+
+  if (missing_normals.size() == mesh.vertices.size()) {
+    generate_normals(mesh);
+  } else if (!missing_normals.empty()) {
+    auto generated = mesh;
+    generate_normals(generated);
+    for (auto i : missing_normals) {
+      mesh.vertices[i].normal = generated.vertices[i].normal;
+    }
+  }
+  spdlog::debug("Loaded {} triangles from \"{}\"", mesh.indices.size() / 3, filename);
+  return mesh;
+}
+
+MeshData load_gltf(const std::string& filename) {
+  auto file = read_file(filename);
+  std::string_view json{file};
+  std::string binary;
+  // .glb files are a header followed by a JSON and an optional binary chunk
+  if (file.size() >= 12 && file.compare(0, 4, "glTF") == 0) {
+    auto read_uint32 = [&](std::size_t offset) {
+      std::uint32_t value;
+      std::memcpy(&value, file.data() + offset, sizeof(value));
+      return value;
+    };
+    if (read_uint32(4) != 2) {
+      throw std::runtime_error("Unsupported glTF version in \"" + filename + "\"");
+    }
+    json = {};
+    for (std::size_t offset = 12; offset + 8 <= file.size();) {
+      std::size_t length = read_uint32(offset);
+      auto type = read_uint32(offset + 4);
+      if (offset + 8 + length > file.size()) {
+        throw std::runtime_error("Truncated chunk in glTF file \"" + filename + "\"");
+      }
+      if (type == 0x4e4f534a) {
+        json = std::string_view{file}.substr(offset + 8, length);
+      } else if (type == 0x004e4942 && binary.empty()) {
+        binary = file.substr(offset + 8, length);
+      }
+      offset += 8 + length;
+    }
+  }
+  auto gltf = JsonParser{json}.parse();
+
+  std::vector<std::string> buffers;
+  auto directory = filename.substr(0, filename.find_last_of('/') + 1);
+  for (const auto& buffer : gltf["buffers"].array) {
+    const auto& uri = buffer["uri"];
+    if (uri.is_null()) {
+      buffers.push_back(std::move(binary));
+    } else if (uri.string.compare(0, 5, "data:") == 0) {
+      auto comma = uri.string.find(',');
+      if (comma == std::string::npos || uri.string.rfind(";base64", comma) == std::string::npos) {
+        throw std::runtime_error("Unsupported data URI in glTF file \"" + filename + "\"");
+      }
+      buffers.push_back(decode_base64(std::string_view{uri.string}.substr(comma + 1), filename));
+    } else {
+      buffers.push_back(read_file(directory + uri.string));
+    }
+  }
+
+  MeshData mesh;
+  for (const auto& gltf_mesh : gltf["meshes"].array) {
+    for (const auto& primitive : gltf_mesh["primitives"].array) {
+      if (primitive["mode"].number_or(GL_TRIANGLES) != GL_TRIANGLES) {
+        spdlog::warn("Skipping a primitive that is not made of triangles in \"{}\"", filename);
+        continue;
+      }
+      append(mesh, load_gltf_primitive(gltf, primitive, buffers, filename));
+    }
+  }
+  spdlog::debug("Loaded {} triangles from \"{}\"", mesh.indices.size() / 3, filename);
+  return mesh;
+}
+
+MeshData load_mesh_data(const std::string& filename) {
+  if (ends_with(filename, ".obj")) {
+    return load_obj(filename);
+  } else if (ends_with(filename, ".gltf") || ends_with(filename, ".glb")) {
+    return load_gltf(filename);
+  }
+  throw std::runtime_error("Failed to detect mesh format from filename \"" + filename + "\"");
+}
+
+void generate_normals(MeshData& mesh) {
+  // the first vertex at each position accumulates the normals of all faces around that position
+  std::unordered_map<glm::vec3, std::uint32_t, PositionHash, PositionEqual> first;
+  std::vector<std::uint32_t> shared(mesh.vertices.size());
+  for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+    shared[i] = first.emplace(mesh.vertices[i].position, static_cast<std::uint32_t>(i)).first->second;
+  }
+
+  std::vector<glm::vec3> normals(mesh.vertices.size(), glm::vec3{0.0f});
+  for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+    const auto& p0 = mesh.vertices[mesh.indices[i]].position;
+    const auto& p1 = mesh.vertices[mesh.indices[i + 1]].position;
+    const auto& p2 = mesh.vertices[mesh.indices[i + 2]].position;
+    // twice the area long, which weights the faces
+    auto normal = glm::cross(p1 - p0, p2 - p0);
+    for (std::size_t corner = 0; corner < 3; ++corner) {
+      normals[shared[mesh.indices[i + corner]]] += normal;
+    }
+  }
+  for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+    auto normal = normals[shared[i]];
+    auto length = glm::length(normal);
+    mesh.vertices[i].normal = length > 0.0f ? normal / length : glm::vec3{0.0f, 0.0f, 1.0f};
+  }
+}
+
+}  // namespace broom
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/mesh_data.hpp>
+
+namespace broom {
+
+// Wavefront OBJ: positions, texture coordinates and normals of all faces, polygons are split into fans.
+// Every face corner becomes its own vertex until deduplicate_vertices() merges them. Only corners without
+// a normal get generated ones, so faces with and without vn can be mixed.
+MeshData load_obj(const std::string& filename);
+// glTF 2.0 as .gltf with external or base64 embedded buffers, or as .glb. The triangles of all meshes are
+// merged in their local space, node transforms, materials, skins and morph targets are ignored.
+MeshData load_gltf(const std::string& filename);
+// picks the loader by file ending, missing normals are generated from the faces
+MeshData load_mesh_data(const std::string& filename);
+
+// smooth normals weighted by face area, shared by all vertices at the same position
+void generate_normals(MeshData& mesh);
+
+}  // namespace broom
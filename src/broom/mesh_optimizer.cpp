@@ -0,0 +1,299 @@
+#include <broom/mesh_optimizer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+#include <broom/hash.hpp>
+
+namespace broom {
+
+namespace {
+
+constexpr std::uint32_t unused = std::numeric_limits<std::uint32_t>::max();
+
+struct VertexHash {
+  std::size_t operator()(const MeshVertex& vertex) const {
+    return fnv1a(std::string_view{reinterpret_cast<const char*>(&vertex), sizeof(vertex)});
+  }
+};
+
+struct VertexEqual {
+  bool operator()(const MeshVertex& lhs, const MeshVertex& rhs) const {
+    return std::memcmp(&lhs, &rhs, sizeof(MeshVertex)) == 0;
+  }
+};
+
+// a FIFO cache in timestamps: a vertex is cached while fewer than cache_size misses happened since its own
+class VertexCache {
+ public:
+  VertexCache(std::size_t vertex_count, unsigned int cache_size)
+      : _times(vertex_count, 0), _time{cache_size + 1}, _size{cache_size} {}
+
+  // true on a miss, which puts the vertex into the cache
+  bool use(std::uint32_t vertex) {
+    if (_time - _times[vertex] > _size) {
+      _times[vertex] = _time++;
+      return true;
+    }
+    return false;
+  }
+
+  // how long ago the vertex entered the cache, larger than the cache size once it dropped out
+  std::uint32_t age(std::uint32_t vertex) const { return _time - _times[vertex]; }
+
+  void flush() { _time += _size + 1; }
+
+ protected:
+  std::vector<std::uint32_t> _times;
+  std::uint32_t _time;
+  std::uint32_t _size;
+};
+
+void remap_indices(std::vector<std::uint32_t>& indices, const std::vector<std::uint32_t>& remap) {
+  for (auto& index : indices) {
+    index = remap[index];
+  }
+}
+
+}  // namespace
+
+double average_cache_miss_ratio(const std::vector<std::uint32_t>& indices,
+                                std::size_t vertex_count,
+                                unsigned int cache_size) {
+  if (indices.size() < 3) {
+    return 0.0;
+  }
+  VertexCache cache{vertex_count, cache_size};
+  std::size_t misses = 0;
+  for (auto index : indices) {
+    misses += cache.use(index);
+  }
+  return static_cast<double>(misses) / (indices.size() / 3);
+}
+
+void deduplicate_vertices(MeshData& mesh) {
+  std::unordered_map<MeshVertex, std::uint32_t, VertexHash, VertexEqual> unique;
+  unique.reserve(mesh.vertices.size());
+  std::vector<std::uint32_t> remap(mesh.vertices.size());
+  std::vector<MeshVertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+  for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+    auto inserted = unique.emplace(mesh.vertices[i], static_cast<std::uint32_t>(vertices.size()));
+    if (inserted.second) {
+      vertices.push_back(mesh.vertices[i]);
+    }
+    remap[i] = inserted.first->second;
+  }
+  remap_indices(mesh.indices, remap);
+  mesh.vertices = std::move(vertices);
+}
+
+std::vector<std::uint32_t> optimize_vertex_cache(MeshData& mesh, unsigned int cache_size) {
+  const auto& indices = mesh.indices;
+  std::size_t vertex_count = mesh.vertices.size();
+  std::size_t triangle_count = indices.size() / 3;
+  std::vector<std::uint32_t> clusters;
+  if (triangle_count == 0) {
+    return clusters;
+  }
+
+  // the triangles around each vertex, adjacent[offsets[v]] to adjacent[offsets[v + 1]]
+  std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+  for (std::size_t i = 0; i < triangle_count * 3; ++i) {
+    ++offsets[indices[i] + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::uint32_t> adjacent(triangle_count * 3);
+  std::vector<std::uint32_t> filled(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0; i < triangle_count * 3; ++i) {
+    adjacent[filled[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+  }
+
+  // triangles not yet emitted around each vertex
+  std::vector<std::uint32_t> live(vertex_count);
+  for (std::size_t v = 0; v < vertex_count; ++v) {
+    live[v] = offsets[v + 1] - offsets[v];
+  }
+  std::vector<bool> emitted(triangle_count, false);
+  std::vector<std::uint32_t> dead_ends;
+  std::vector<std::uint32_t> candidates;
+  std::vector<std::uint32_t> result;
+  result.reserve(triangle_count * 3);
+  VertexCache cache{vertex_count, cache_size};
+
+  std::size_t cursor = 0;
+  auto next_unprocessed = [&]() {
+    for (; cursor < vertex_count; ++cursor) {
+      if (live[cursor] > 0) {
+        return static_cast<std::uint32_t>(cursor++);
+      }
+    }
+    return unused;
+  };
+
+  auto fan = next_unprocessed();
+  clusters.push_back(0);
+  while (fan != unused) {
+    candidates.clear();
+    for (auto i = offsets[fan]; i < offsets[fan + 1]; ++i) {
+      auto triangle = adjacent[i];
+      if (emitted[triangle]) {
+        continue;
+      }
+      for (std::size_t corner = 0; corner < 3; ++corner) {
+        auto vertex = indices[3 * triangle + corner];
+        result.push_back(vertex);
+        dead_ends.push_back(vertex);
+        candidates.push_back(vertex);
+        --live[vertex];
+        cache.use(vertex);
+      }
+      emitted[triangle] = true;
+    }
+
+    // fan around the candidate that entered the cache earliest and is still cached after its own fan
+    fan = unused;
+    std::int64_t best = -1;
+    for (auto vertex : candidates) {
+      if (live[vertex] == 0) {
+        continue;
+      }
+      std::int64_t priority = 0;
+      if (cache.age(vertex) + 2 * live[vertex] <= cache_size) {
+        priority = cache.age(vertex);
+      }
+      if (priority > best) {
+        best = priority;
+        fan = vertex;
+      }
+    }
+    if (fan != unused) {
+      continue;
+    }
+
+    // dead end, back up to a recently used vertex or start over elsewhere
+    while (!dead_ends.empty() && fan == unused) {
+      if (live[dead_ends.back()] > 0) {
+        fan = dead_ends.back();
+      }
+      dead_ends.pop_back();
+    }
+    if (fan == unused) {
+      fan = next_unprocessed();
+    }
+    if (fan != unused) {
+      clusters.push_back(static_cast<std::uint32_t>(result.size() / 3));
+    }
+  }
+
+  mesh.indices = std::move(result);
+  return clusters;
+}
+
+void optimize_overdraw(MeshData& mesh,
+                       const std::vector<std::uint32_t>& clusters,
+                       float threshold,
+                       unsigned int cache_size) {
+  const auto& indices = mesh.indices;
+  const auto& vertices = mesh.vertices;
+  std::size_t triangle_count = indices.size() / 3;
+  if (triangle_count == 0 || clusters.empty()) {
+    return;
+  }
+
+  // split where the cluster alone, starting with a cold cache, is about as efficient as the whole mesh
+  double limit = threshold * average_cache_miss_ratio(indices, vertices.size(), cache_size);
+  std::vector<std::uint32_t> starts;
+  VertexCache cache{vertices.size(), cache_size};
+  for (std::size_t c = 0; c < clusters.size(); ++c) {
+    std::size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangle_count;
+    std::size_t start = clusters[c];
+    std::size_t misses = 0;
+    starts.push_back(clusters[c]);
+    cache.flush();
+    for (std::size_t triangle = clusters[c]; triangle < end; ++triangle) {
+      for (std::size_t corner = 0; corner < 3; ++corner) {
+        misses += cache.use(indices[3 * triangle + corner]);
+      }
+      if (triangle + 1 < end && misses <= limit * (triangle + 1 - start)) {
+        start = triangle + 1;
+        misses = 0;
+        starts.push_back(static_cast<std::uint32_t>(start));
+        cache.flush();
+      }
+    }
+  }
+
+  glm::vec3 mesh_centroid{0.0f};
+  for (std::size_t i = 0; i < triangle_count * 3; ++i) {
+    mesh_centroid += vertices[indices[i]].position;
+  }
+  mesh_centroid /= static_cast<float>(triangle_count * 3);
+
+  // clusters whose area weighted normal points away from the center come first
+  std::vector<float> facing(starts.size());
+  for (std::size_t c = 0; c < starts.size(); ++c) {
+    std::size_t end = c + 1 < starts.size() ? starts[c + 1] : triangle_count;
+    glm::vec3 centroid{0.0f};
+    glm::vec3 normal{0.0f};
+    float area = 0.0f;
+    for (std::size_t triangle = starts[c]; triangle < end; ++triangle) {
+      const auto& p0 = vertices[indices[3 * triangle + 0]].position;
+      const auto& p1 = vertices[indices[3 * triangle + 1]].position;
+      const auto& p2 = vertices[indices[3 * triangle + 2]].position;
+      auto cross = glm::cross(p1 - p0, p2 - p0);
+      auto triangle_area = glm::length(cross);
+      centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+      normal += cross;
+      area += triangle_area;
+    }
+    float normal_length = glm::length(normal);
+    facing[c] = area > 0.0f && normal_length > 0.0f ? glm::dot(centroid / area - mesh_centroid, normal / normal_length)
+                                                    : 0.0f;
+  }
+
+  std::vector<std::uint32_t> order(starts.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::uint32_t lhs, std::uint32_t rhs) { return facing[lhs] > facing[rhs]; });
+
+  std::vector<std::uint32_t> result;
+  result.reserve(indices.size());
+  for (auto c : order) {
+    std::size_t end = c + 1 < starts.size() ? starts[c + 1] : triangle_count;
+    result.insert(result.end(), indices.begin() + 3 * starts[c], indices.begin() + 3 * end);
+  }
+  mesh.indices = std::move(result);
+}
+
+void optimize_vertex_fetch(MeshData& mesh) {
+  std::vector<std::uint32_t> remap(mesh.vertices.size(), unused);
+  std::vector<MeshVertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+  for (auto index : mesh.indices) {
+    if (remap[index] == unused) {
+      remap[index] = static_cast<std::uint32_t>(vertices.size());
+      vertices.push_back(mesh.vertices[index]);
+    }
+  }
+  remap_indices(mesh.indices, remap);
+  mesh.vertices = std::move(vertices);
+}
+
+void optimize_mesh(MeshData& mesh) {
+  auto vertex_count = mesh.vertices.size();
+  auto miss_ratio = average_cache_miss_ratio(mesh.indices, mesh.vertices.size());
+  deduplicate_vertices(mesh);
+  auto clusters = optimize_vertex_cache(mesh);
+  optimize_overdraw(mesh, clusters);
+  optimize_vertex_fetch(mesh);
+  spdlog::debug("Optimized mesh of {} triangles: {} to {} vertices, ACMR {:.3f} to {:.3f}", mesh.indices.size() / 3,
+                vertex_count, mesh.vertices.size(), miss_ratio,
+                average_cache_miss_ratio(mesh.indices, mesh.vertices.size()));
+}
+
+}  // namespace broom
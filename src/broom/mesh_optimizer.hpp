@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/mesh_data.hpp>
+
+namespace broom {
+
+// a conservative size for the post-transform vertex cache modeled as a FIFO
+constexpr unsigned int default_vertex_cache_size = 16;
+
+// vertex shader invocations per triangle, between 0.5 for large regular grids and 3
+double average_cache_miss_ratio(const std::vector<std::uint32_t>& indices,
+                                std::size_t vertex_count,
+                                unsigned int cache_size = default_vertex_cache_size);
+
+// merges bitwise identical vertices, e.g. the corners OBJ faces repeat
+void deduplicate_vertices(MeshData& mesh);
+// Tipsify by Sander, Nehab and Barczak, reorders triangles into fans that reuse the cached vertices.
+// Returns the first triangle of each cluster the fans form, which optimize_overdraw() reorders.
+std::vector<std::uint32_t> optimize_vertex_cache(MeshData& mesh, unsigned int cache_size = default_vertex_cache_size);
+// splits the clusters further while their cache miss ratio stays within threshold times that of the mesh,
+// then draws the clusters facing outwards first so that they occlude the rest
+void optimize_overdraw(MeshData& mesh,
+                       const std::vector<std::uint32_t>& clusters,
+                       float threshold = 1.05f,
+                       unsigned int cache_size = default_vertex_cache_size);
+// orders vertices by their first use so that the vertex fetch reads memory linearly, drops unused ones
+void optimize_vertex_fetch(MeshData& mesh);
+// all of the above in order
+void optimize_mesh(MeshData& mesh);
+
+}  // namespace broom
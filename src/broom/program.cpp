@@ -39,27 +39,135 @@ void Program::detach_shader(const Shader& shader) const {
   glDetachShader(_id, shader.id());
 }
 
-bool Program::link() const {
+bool Program::link() {
   glLinkProgram(_id);
   if (!link_status()) {
     spdlog::error("Failed to link program {}:\n{}", _id, info_log());
     return false;
   }
+  reflect();
 
   spdlog::debug("Linked program {}", _id);
   return true;
 }
 
+void Program::link_async() const {
+  glLinkProgram(_id);
+}
+
+bool Program::completion_status() const {
+  if (!GLAD_GL_KHR_parallel_shader_compile) {
+    return true;
+  }
+  return get_parameter(GL_COMPLETION_STATUS_KHR) != GL_FALSE;
+}
+
+void Program::set_binary_retrievable(bool retrievable) const {
+  glProgramParameteri(_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, retrievable ? GL_TRUE : GL_FALSE);
+}
+
+std::vector<std::uint8_t> Program::binary(GLenum& format) const {
+  std::vector<std::uint8_t> result(get_parameter(GL_PROGRAM_BINARY_LENGTH));
+  GLsizei length = 0;
+  glGetProgramBinary(_id, static_cast<GLsizei>(result.size()), &length, &format, result.data());
+  result.resize(length);
+  return result;
+}
+
+bool Program::load_binary(GLenum format, const void* data, GLsizei size) {
+  glProgramBinary(_id, format, data, size);
+  if (!link_status()) {
+    return false;
+  }
+  reflect();
+  return true;
+}
+
+void Program::reflect() {
+  _uniforms.reflect(_id, GL_UNIFORM);
+  _uniform_blocks.reflect(_id, GL_UNIFORM_BLOCK);
+  _storage_blocks.reflect(_id, GL_SHADER_STORAGE_BLOCK);
+  _attributes.reflect(_id, GL_PROGRAM_INPUT);
+  spdlog::debug("Program {} has {} uniforms, {} uniform blocks, {} storage blocks and {} attributes", _id,
+                _uniforms.size(), _uniform_blocks.size(), _storage_blocks.size(), _attributes.size());
+}
+
+void Program::swap(Program& other) {
+  std::swap(_id, other._id);
+  std::swap(_uniforms, other._uniforms);
+  std::swap(_uniform_blocks, other._uniform_blocks);
+  std::swap(_storage_blocks, other._storage_blocks);
+  std::swap(_attributes, other._attributes);
+}
+
 void Program::use() const {
-  glUseProgram(_id);
+  StateCache::current().use_program(_id);
 }
 
 void Program::unuse() {
-  glUseProgram(0);
+  StateCache::current().use_program(0);
+}
+
+const ProgramInterface& Program::uniforms() const {
+  return _uniforms;
+}
+
+const ProgramInterface& Program::uniform_blocks() const {
+  return _uniform_blocks;
+}
+
+const ProgramInterface& Program::storage_blocks() const {
+  return _storage_blocks;
+}
+
+const ProgramInterface& Program::attributes() const {
+  return _attributes;
+}
+
+GLint Program::attribute_location(std::uint64_t name_hash) const {
+  auto attribute = _attributes.find(name_hash);
+  return attribute ? attribute->location : -1;
+}
+
+GLint Program::uniform_block_index(std::uint64_t name_hash) const {
+  auto block = _uniform_blocks.find(name_hash);
+  return block ? static_cast<GLint>(block->index) : -1;
+}
+
+GLint Program::storage_block_index(std::uint64_t name_hash) const {
+  auto block = _storage_blocks.find(name_hash);
+  return block ? static_cast<GLint>(block->index) : -1;
+}
+
+bool Program::set_uniform_block_binding(std::uint64_t name_hash, GLuint binding) {
+  auto block = _uniform_blocks.find(name_hash);
+  if (!block) {
+    return false;
+  }
+  glUniformBlockBinding(_id, block->index, binding);
+  // keeps the reflected binding current
+  _uniform_blocks.reflect(_id, GL_UNIFORM_BLOCK);
+  return true;
+}
+
+bool Program::set_storage_block_binding(std::uint64_t name_hash, GLuint binding) {
+  auto block = _storage_blocks.find(name_hash);
+  if (!block) {
+    return false;
+  }
+  glShaderStorageBlockBinding(_id, block->index, binding);
+  _storage_blocks.reflect(_id, GL_SHADER_STORAGE_BLOCK);
+  return true;
+}
+
+GLint Program::uniform_location(std::uint64_t name_hash) const {
+  auto uniform = _uniforms.find(name_hash);
+  return uniform ? uniform->location : -1;
 }
 
 GLint Program::uniform_location(const std::string& name) const {
-  return glGetUniformLocation(_id, name.c_str());
+  auto uniform = _uniforms.find(name);
+  return uniform ? uniform->location : glGetUniformLocation(_id, name.c_str());
 }
 
 void Program::set_uniform_1i(GLint location, GLint value) {
@@ -72,19 +180,19 @@ void Program::set_uniform_2i(GLint location, const std::array<GLint, 2>& value)
   glProgramUniform2i(_id, location, value[0], value[1]);
 }
 void Program::set_uniform_2i(GLint location, const std::vector<GLint>& value) {
-  glProgramUniform2iv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform2iv(_id, location, static_cast<GLsizei>(value.size() / 2), value.data());
 }
 void Program::set_uniform_3i(GLint location, const std::array<GLint, 3>& value) {
   glProgramUniform3i(_id, location, value[0], value[1], value[2]);
 }
 void Program::set_uniform_3i(GLint location, const std::vector<GLint>& value) {
-  glProgramUniform3iv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform3iv(_id, location, static_cast<GLsizei>(value.size() / 3), value.data());
 }
 void Program::set_uniform_4i(GLint location, const std::array<GLint, 4>& value) {
   glProgramUniform4i(_id, location, value[0], value[1], value[2], value[3]);
 }
 void Program::set_uniform_4i(GLint location, const std::vector<GLint>& value) {
-  glProgramUniform4iv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform4iv(_id, location, static_cast<GLsizei>(value.size() / 4), value.data());
 }
 
 void Program::set_uniform_1ui(GLint location, GLuint value) {
@@ -97,19 +205,19 @@ void Program::set_uniform_2ui(GLint location, const std::array<GLuint, 2>& value
   glProgramUniform2ui(_id, location, value[0], value[1]);
 }
 void Program::set_uniform_2ui(GLint location, const std::vector<GLuint>& value) {
-  glProgramUniform2uiv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform2uiv(_id, location, static_cast<GLsizei>(value.size() / 2), value.data());
 }
 void Program::set_uniform_3ui(GLint location, const std::array<GLuint, 3>& value) {
   glProgramUniform3ui(_id, location, value[0], value[1], value[2]);
 }
 void Program::set_uniform_3ui(GLint location, const std::vector<GLuint>& value) {
-  glProgramUniform3uiv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform3uiv(_id, location, static_cast<GLsizei>(value.size() / 3), value.data());
 }
 void Program::set_uniform_4ui(GLint location, const std::array<GLuint, 4>& value) {
   glProgramUniform4ui(_id, location, value[0], value[1], value[2], value[3]);
 }
 void Program::set_uniform_4ui(GLint location, const std::vector<GLuint>& value) {
-  glProgramUniform4uiv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform4uiv(_id, location, static_cast<GLsizei>(value.size() / 4), value.data());
 }
 
 void Program::set_uniform_1f(GLint location, GLfloat value) {
@@ -122,19 +230,19 @@ void Program::set_uniform_2f(GLint location, const std::array<GLfloat, 2>& value
   glProgramUniform2f(_id, location, value[0], value[1]);
 }
 void Program::set_uniform_2f(GLint location, const std::vector<GLfloat>& value) {
-  glProgramUniform2fv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform2fv(_id, location, static_cast<GLsizei>(value.size() / 2), value.data());
 }
 void Program::set_uniform_3f(GLint location, const std::array<GLfloat, 3>& value) {
   glProgramUniform3f(_id, location, value[0], value[1], value[2]);
 }
 void Program::set_uniform_3f(GLint location, const std::vector<GLfloat>& value) {
-  glProgramUniform3fv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform3fv(_id, location, static_cast<GLsizei>(value.size() / 3), value.data());
 }
 void Program::set_uniform_4f(GLint location, const std::array<GLfloat, 4>& value) {
   glProgramUniform4f(_id, location, value[0], value[1], value[2], value[3]);
 }
 void Program::set_uniform_4f(GLint location, const std::vector<GLfloat>& value) {
-  glProgramUniform4fv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform4fv(_id, location, static_cast<GLsizei>(value.size() / 4), value.data());
 }
 
 void Program::set_uniform_1d(GLint location, GLdouble value) {
@@ -147,19 +255,19 @@ void Program::set_uniform_2d(GLint location, const std::array<GLdouble, 2>& valu
   glProgramUniform2d(_id, location, value[0], value[1]);
 }
 void Program::set_uniform_2d(GLint location, const std::vector<GLdouble>& value) {
-  glProgramUniform2dv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform2dv(_id, location, static_cast<GLsizei>(value.size() / 2), value.data());
 }
 void Program::set_uniform_3d(GLint location, const std::array<GLdouble, 3>& value) {
   glProgramUniform3d(_id, location, value[0], value[1], value[2]);
 }
 void Program::set_uniform_3d(GLint location, const std::vector<GLdouble>& value) {
-  glProgramUniform3dv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform3dv(_id, location, static_cast<GLsizei>(value.size() / 3), value.data());
 }
 void Program::set_uniform_4d(GLint location, const std::array<GLdouble, 4>& value) {
   glProgramUniform4d(_id, location, value[0], value[1], value[2], value[3]);
 }
 void Program::set_uniform_4d(GLint location, const std::vector<GLdouble>& value) {
-  glProgramUniform4dv(_id, location, static_cast<GLsizei>(value.size()), value.data());
+  glProgramUniform4dv(_id, location, static_cast<GLsizei>(value.size() / 4), value.data());
 }
 
 void Program::set_uniform_matrix_22f(GLint location, const std::vector<GLfloat>& value, bool transpose) {
@@ -234,6 +342,7 @@ GLint Program::get_parameter(GLenum parameter) const {
 
 void Program::destroy() const {
   if (valid()) {
+    StateCache::current().forget_program(_id);
     glDeleteProgram(_id);
   }
 }
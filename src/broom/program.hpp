@@ -1,12 +1,20 @@
 #pragma once
 
+#include <cstdint>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
+#include <broom/hash.hpp>
 #include <broom/opengl.hpp>
+#include <broom/program_interface.hpp>
+#include <broom/span.hpp>
 #include <broom/shader.hpp>
+#include <broom/state_cache.hpp>
+#include <broom/uniform.hpp>
 
 namespace broom {
 
@@ -29,12 +37,59 @@ class Program {
 
   void attach_shader(const Shader& shader) const;
   void detach_shader(const Shader& shader) const;
-  bool link() const;
+  // reflects the active resources on success
+  bool link();
+  // starts linking without waiting for the result, see completion_status()
+  void link_async() const;
+  // false while a parallel link is still running, always true without GL_KHR_parallel_shader_compile
+  bool completion_status() const;
+  std::string info_log() const;
+
+  // must be set before linking for binary() to be available
+  void set_binary_retrievable(bool retrievable) const;
+  std::vector<std::uint8_t> binary(GLenum& format) const;
+  // false if the driver rejects the binary, e.g. after an update, the program then needs to be linked
+  bool load_binary(GLenum format, const void* data, GLsizei size);
+  // queries the active uniforms, blocks and attributes, done by link() and load_binary()
+  void reflect();
+  // exchanges the underlying program objects, e.g. to replace a program with a rebuilt one
+  void swap(Program& other);
   void use() const;
   static void unuse();
 
+  const ProgramInterface& uniforms() const;
+  const ProgramInterface& uniform_blocks() const;
+  const ProgramInterface& storage_blocks() const;
+  const ProgramInterface& attributes() const;
+  // -1 if the program has no such active resource
+  GLint attribute_location(std::uint64_t name_hash) const;
+  GLint uniform_block_index(std::uint64_t name_hash) const;
+  GLint storage_block_index(std::uint64_t name_hash) const;
+  // points the block at an indexed buffer binding, false if the program has no such active block
+  bool set_uniform_block_binding(std::uint64_t name_hash, GLuint binding);
+  bool set_storage_block_binding(std::uint64_t name_hash, GLuint binding);
+
   // uniforms
+  // -1 if the program has no such active uniform, e.g. uniform_location("model"_hash)
+  GLint uniform_location(std::uint64_t name_hash) const;
+  // also finds array elements and struct members, which only the driver can resolve
   GLint uniform_location(const std::string& name) const;
+
+  // the GL call is picked from the type, e.g. GLint, glm::vec3 or glm::mat4
+  template <typename T>
+  void set_uniform(GLint location, const T& value) {
+    Uniform<T>::set(_id, location, 1, &value);
+  }
+  // sets consecutive array elements from location on, one per value
+  template <typename T>
+  void set_uniform(GLint location, Span<T> values) {
+    Uniform<std::remove_const_t<T>>::set(_id, location, static_cast<GLsizei>(values.size()), values.data());
+  }
+  template <typename T>
+  void set_uniform(GLint location, const std::vector<T>& values) {
+    set_uniform(location, Span<const T>{values});
+  }
+
   void set_uniform_1i(GLint location, GLint value);
   void set_uniform_1i(GLint location, const std::vector<GLint>& value);
   void set_uniform_2i(GLint location, const std::array<GLint, 2>& value);
@@ -92,12 +147,15 @@ class Program {
   void set_uniform_matrix_43d(GLint location, const std::vector<GLdouble>& value, bool transpose = false);
 
  protected:
-  std::string info_log() const;
   GLint get_parameter(GLenum parameter) const;
   void destroy() const;
 
  protected:
   GLuint _id;
+  ProgramInterface _uniforms;
+  ProgramInterface _uniform_blocks;
+  ProgramInterface _storage_blocks;
+  ProgramInterface _attributes;
 };
 
 }  // namespace broom
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include <broom/program_cache.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace broom {
+
+namespace {
+
+constexpr std::uint32_t binary_magic = 0x42505242;  // "BRPB"
+
+std::string gl_string(GLenum name) {
+  auto value = glGetString(name);
+  return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+}  // namespace
+
+ProgramCache::ProgramCache(const std::string& directory, std::uintmax_t max_size)
+    : _directory{directory}, _max_size{max_size}, _driver_hash{0}, _supported{false}, _statistics{0, 0, 0} {
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  _supported = formats > 0;
+  if (!_supported) {
+    spdlog::info("The driver supports no program binary formats, programs will always be compiled");
+    return;
+  }
+
+  _driver_hash = fnv1a(gl_string(GL_VENDOR));
+  _driver_hash = fnv1a(gl_string(GL_RENDERER), _driver_hash);
+  _driver_hash = fnv1a(gl_string(GL_VERSION), _driver_hash);
+
+  std::error_code error;
+  std::filesystem::create_directories(_directory, error);
+  if (error) {
+    spdlog::warn("Failed to create program cache directory '{}': {}", _directory.string(), error.message());
+    _supported = false;
+  }
+}
+
+bool ProgramCache::supported() const {
+  return _supported;
+}
+
+const ProgramCacheStatistics& ProgramCache::statistics() const {
+  return _statistics;
+}
+
+std::uintmax_t ProgramCache::size() const {
+  std::uintmax_t size = 0;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator{_directory, error}) {
+    if (entry.path().extension() == ".bin") {
+      size += entry.file_size(error);
+    }
+  }
+  return size;
+}
+
+std::unique_ptr<Program> ProgramCache::load(const std::vector<std::string>& filenames,
+                                            const std::vector<std::string>& defines) {
+  std::vector<std::pair<GLenum, std::string>> sources;
+  auto key = _driver_hash;
+  for (const auto& filename : filenames) {
+    auto type = detect_shader_type_from_filename(filename);
+    if (type == GL_NONE) {
+      throw std::runtime_error("Failed to detect shader type from filename \"" + filename + "\"");
+    }
+    sources.emplace_back(type, load_shader_source(filename, defines));
+    // the separators keep different splits of the same text apart
+    constexpr std::string_view separator{"\0", 1};
+    key = fnv1a(separator, fnv1a(std::to_string(type), key));
+    key = fnv1a(separator, fnv1a(sources.back().second, key));
+  }
+
+  auto program = std::make_unique<Program>();
+  if (_supported && load_binary(*program, key)) {
+    ++_statistics.hits;
+    return program;
+  }
+  ++_statistics.misses;
+
+  // a program that rejected a binary starts over
+  program = std::make_unique<Program>();
+  std::vector<Shader> shaders;
+  shaders.reserve(sources.size());
+  for (const auto& source : sources) {
+    shaders.emplace_back(source.first);
+    shaders.back().set_source(source.second);
+    if (!shaders.back().compile()) {
+      throw std::runtime_error("Failed to compile shader for program cache entry " + path(key).string());
+    }
+    program->attach_shader(shaders.back());
+  }
+  if (_supported) {
+    program->set_binary_retrievable(true);
+  }
+  if (!program->link()) {
+    throw std::runtime_error("Failed to link program for program cache entry " + path(key).string());
+  }
+
+  if (_supported) {
+    store_binary(*program, key);
+  }
+  return program;
+}
+
+void ProgramCache::clear() {
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator{_directory, error}) {
+    if (entry.path().extension() == ".bin") {
+      std::filesystem::remove(entry.path(), error);
+    }
+  }
+}
+
+std::filesystem::path ProgramCache::path(std::uint64_t key) const {
+  return _directory / fmt::format("{:016x}.bin", key);
+}
+
+bool ProgramCache::load_binary(Program& program, std::uint64_t key) {
+  auto filename = path(key);
+  std::ifstream stream{filename, std::ios::binary};
+  if (!stream) {
+    return false;
+  }
+  std::vector<std::uint8_t> file{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+  stream.close();
+
+  constexpr std::size_t header = 16;
+  std::uint32_t magic = 0;
+  std::uint32_t format = 0;
+  std::uint64_t stored_key = 0;
+  if (file.size() > header) {
+    std::memcpy(&magic, &file[0], 4);
+    std::memcpy(&format, &file[4], 4);
+    std::memcpy(&stored_key, &file[8], 8);
+  }
+  if (magic != binary_magic || stored_key != key ||
+      !program.load_binary(format, &file[header], static_cast<GLsizei>(file.size() - header))) {
+    spdlog::debug("Program binary {} was rejected", filename.string());
+    ++_statistics.rejected;
+    std::error_code error;
+    std::filesystem::remove(filename, error);
+    return false;
+  }
+
+  // the modification time orders the least recently used binaries for trim()
+  std::error_code error;
+  std::filesystem::last_write_time(filename, std::filesystem::file_time_type::clock::now(), error);
+  spdlog::debug("Loaded program {} from binary {}", program.id(), filename.string());
+  return true;
+}
+
+void ProgramCache::store_binary(const Program& program, std::uint64_t key) {
+  GLenum format = GL_NONE;
+  auto binary = program.binary(format);
+  if (binary.empty()) {
+    return;
+  }
+
+  auto filename = path(key);
+  std::ofstream stream{filename, std::ios::binary | std::ios::trunc};
+  std::uint32_t stored_format = format;
+  stream.write(reinterpret_cast<const char*>(&binary_magic), 4);
+  stream.write(reinterpret_cast<const char*>(&stored_format), 4);
+  stream.write(reinterpret_cast<const char*>(&key), 8);
+  stream.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+  if (!stream) {
+    spdlog::warn("Failed to write program binary {}", filename.string());
+    return;
+  }
+  stream.close();
+  trim();
+}
+
+void ProgramCache::trim() {
+  std::vector<std::filesystem::directory_entry> entries;
+  std::uintmax_t total = 0;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator{_directory, error}) {
+    if (entry.path().extension() == ".bin") {
+      entries.push_back(entry);
+      total += entry.file_size(error);
+    }
+  }
+  if (total <= _max_size) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    std::error_code error;
+    return lhs.last_write_time(error) < rhs.last_write_time(error);
+  });
+  for (const auto& entry : entries) {
+    if (total <= _max_size) {
+      break;
+    }
+    total -= entry.file_size(error);
+    std::filesystem::remove(entry.path(), error);
+    spdlog::debug("Removed program binary {} from the cache", entry.path().string());
+  }
+}
+
+}  // namespace broom
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/hash.hpp>
+#include <broom/opengl.hpp>
+#include <broom/program.hpp>
+#include <broom/shader.hpp>
+
+namespace broom {
+
+struct ProgramCacheStatistics {
+  std::size_t hits;
+  std::size_t misses;
+  // binaries found on disk that the driver did not accept
+  std::size_t rejected;
+};
+
+// Stores linked program binaries on disk so that later runs can skip compiling and linking.
+//
+// Binaries are keyed by a hash of every stage's type and source, the defines and the GL vendor, renderer
+// and version strings, so driver updates and source edits miss instead of loading stale binaries. The
+// least recently used files are deleted once the directory grows beyond max_size.
+class ProgramCache {
+ public:
+  ProgramCache(const std::string& directory, std::uintmax_t max_size = 64 * 1024 * 1024);
+  ProgramCache(const ProgramCache&) = delete;
+  ProgramCache(ProgramCache&&) = delete;
+
+  ProgramCache& operator=(const ProgramCache& other) = delete;
+  ProgramCache& operator=(ProgramCache&& other) = delete;
+
+  // false if the driver has no binary formats, programs are then always compiled
+  bool supported() const;
+  const ProgramCacheStatistics& statistics() const;
+  // total size of the cached binaries
+  std::uintmax_t size() const;
+
+  // shader types are detected from the filenames, throws if compiling or linking fails
+  std::unique_ptr<Program> load(const std::vector<std::string>& filenames,
+                                const std::vector<std::string>& defines = {});
+  void clear();
+
+ protected:
+  std::filesystem::path path(std::uint64_t key) const;
+  bool load_binary(Program& program, std::uint64_t key);
+  void store_binary(const Program& program, std::uint64_t key);
+  void trim();
+
+ protected:
+  std::filesystem::path _directory;
+  std::uintmax_t _max_size;
+  std::uint64_t _driver_hash;
+  bool _supported;
+  ProgramCacheStatistics _statistics;
+};
+
+}  // namespace broom
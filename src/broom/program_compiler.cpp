@@ -0,0 +1,125 @@
+#include <broom/program_compiler.hpp>
+
+#include <algorithm>
+
+namespace broom {
+
+ProgramBuild::ProgramBuild() {}
+
+bool ProgramBuild::valid() const {
+  return _state != nullptr;
+}
+
+bool ProgramBuild::ready() const {
+  return _state && _state->ready;
+}
+
+bool ProgramBuild::failed() const {
+  return _state && _state->failed;
+}
+
+std::shared_ptr<Program> ProgramBuild::program() const {
+  return ready() && !failed() ? _state->program : nullptr;
+}
+
+ProgramCompiler::ProgramCompiler(GLuint threads) : _parallel{GLAD_GL_KHR_parallel_shader_compile != 0} {
+  if (_parallel) {
+    glMaxShaderCompilerThreadsKHR(threads > 0 ? threads : 0xFFFFFFFF);
+  } else {
+    spdlog::info("GL_KHR_parallel_shader_compile is not supported, programs are built one per frame");
+  }
+}
+
+bool ProgramCompiler::parallel() const {
+  return _parallel;
+}
+
+std::size_t ProgramCompiler::pending() const {
+  return _jobs.size();
+}
+
+ProgramBuild ProgramCompiler::submit(const std::vector<std::string>& filenames,
+                                     const std::vector<std::string>& defines) {
+  Job job{{}, std::make_shared<Program>(), false, std::make_shared<ProgramBuild::State>()};
+  job.shaders.reserve(filenames.size());
+  for (const auto& filename : filenames) {
+    auto type = detect_shader_type_from_filename(filename);
+    if (type == GL_NONE) {
+      throw std::runtime_error("Failed to detect shader type from filename \"" + filename + "\"");
+    }
+    job.shaders.emplace_back(type);
+    job.shaders.back().set_source(load_shader_source(filename, defines));
+  }
+  for (const auto& shader : job.shaders) {
+    shader.compile_async();
+  }
+
+  ProgramBuild build;
+  build._state = job.state;
+  _jobs.push_back(std::move(job));
+  return build;
+}
+
+std::size_t ProgramCompiler::poll() {
+  std::size_t finished = 0;
+  for (auto job = _jobs.begin(); job != _jobs.end();) {
+    // without parallel compiling the first job blocks anyway, the others wait for later frames
+    if (!_parallel && finished > 0) {
+      break;
+    }
+    if (advance(*job, !_parallel)) {
+      job = _jobs.erase(job);
+      ++finished;
+    } else {
+      ++job;
+    }
+  }
+  return finished;
+}
+
+void ProgramCompiler::finish() {
+  for (auto& job : _jobs) {
+    advance(job, true);
+  }
+  _jobs.clear();
+}
+
+bool ProgramCompiler::advance(Job& job, bool wait) const {
+  if (!job.linking) {
+    if (!wait && !std::all_of(job.shaders.begin(), job.shaders.end(),
+                              [](const Shader& shader) { return shader.completion_status(); })) {
+      return false;
+    }
+    for (const auto& shader : job.shaders) {
+      if (!shader.compile_status()) {
+        spdlog::error("Compiling shader {} failed:\n{}", shader.id(), shader.info_log());
+        job.state->ready = true;
+        job.state->failed = true;
+        return true;
+      }
+      job.program->attach_shader(shader);
+    }
+    job.program->link_async();
+    job.linking = true;
+  }
+
+  if (!wait && !job.program->completion_status()) {
+    return false;
+  }
+  // the shaders are deleted with the job once they no longer are attached
+  for (const auto& shader : job.shaders) {
+    job.program->detach_shader(shader);
+  }
+  job.state->ready = true;
+  if (!job.program->link_status()) {
+    spdlog::error("Failed to link program {}:\n{}", job.program->id(), job.program->info_log());
+    job.state->failed = true;
+    return true;
+  }
+  job.program->reflect();
+  spdlog::debug("Linked program {}", job.program->id());
+  job.state->program = job.program;
+  return true;
+}
+
+}  // namespace broom
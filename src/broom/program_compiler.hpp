@@ -0,0 +1,83 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+#include <broom/program.hpp>
+#include <broom/shader.hpp>
+
+namespace broom {
+
+// Result of a program submitted to a ProgramCompiler, the program is available once it is ready.
+class ProgramBuild {
+ public:
+  ProgramBuild();
+
+  bool valid() const;
+  // finished, successfully or not
+  bool ready() const;
+  bool failed() const;
+  // null until the build is ready and stays null if it failed
+  std::shared_ptr<Program> program() const;
+
+ protected:
+  friend class ProgramCompiler;
+  struct State {
+    bool ready;
+    bool failed;
+    std::shared_ptr<Program> program;
+  };
+  std::shared_ptr<State> _state;
+};
+
+// Compiles and links programs without blocking the render loop.
+//
+// All shaders are submitted to the driver up front. With GL_KHR_parallel_shader_compile the driver
+// compiles and links them on its own threads, poll() only checks the completion status and moves builds
+// whose shaders are done on to linking. Without the extension the work happens in the GL calls, poll()
+// then finishes a single build per call so the stall is spread over frames.
+class ProgramCompiler {
+ public:
+  // 0 lets the driver pick the number of compiler threads
+  ProgramCompiler(GLuint threads = 0);
+  ProgramCompiler(const ProgramCompiler&) = delete;
+  ProgramCompiler(ProgramCompiler&&) = delete;
+
+  ProgramCompiler& operator=(const ProgramCompiler& other) = delete;
+  ProgramCompiler& operator=(ProgramCompiler&& other) = delete;
+
+  bool parallel() const;
+  // builds not yet ready
+  std::size_t pending() const;
+
+  // shader types are detected from the filenames, throws if a source can't be read
+  ProgramBuild submit(const std::vector<std::string>& filenames, const std::vector<std::string>& defines = {});
+  // call once per frame, returns the number of builds that became ready
+  std::size_t poll();
+  // blocks until every submitted build is ready
+  void finish();
+
+ protected:
+  struct Job {
+    std::vector<Shader> shaders;
+    std::shared_ptr<Program> program;
+    bool linking;
+    std::shared_ptr<ProgramBuild::State> state;
+  };
+
+  // moves the job on as far as the driver allows without waiting, or completely if wait is set,
+  // returns whether it is ready
+  bool advance(Job& job, bool wait) const;
+
+ protected:
+  bool _parallel;
+  std::list<Job> _jobs;
+};
+
+}  // namespace broom
@@ -0,0 +1,107 @@
+#include <broom/program_interface.hpp>
+
+#include <algorithm>
+
+namespace broom {
+
+ProgramInterface::ProgramInterface() {}
+
+void ProgramInterface::reflect(GLuint program, GLenum interface) {
+  clear();
+
+  GLint count = 0;
+  glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+  _resources.reserve(count);
+
+  bool variables = interface == GL_UNIFORM || interface == GL_PROGRAM_INPUT;
+  for (GLint i = 0; i < count; ++i) {
+    ProgramResource resource{{}, 0, static_cast<GLuint>(i), GL_NONE, -1, -1, -1, -1};
+    GLint name_length = 0;
+    if (variables) {
+      const GLenum properties[] = {GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE};
+      GLint values[4];
+      glGetProgramResourceiv(program, interface, i, 4, properties, 4, nullptr, values);
+      name_length = values[0];
+      resource.type = values[1];
+      resource.location = values[2];
+      resource.array_size = values[3];
+      // block members are set through their block and built-in inputs have no location
+      if (resource.location < 0) {
+        continue;
+      }
+    } else {
+      const GLenum properties[] = {GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+      GLint values[3];
+      glGetProgramResourceiv(program, interface, i, 3, properties, 3, nullptr, values);
+      name_length = values[0];
+      resource.binding = values[1];
+      resource.data_size = values[2];
+    }
+
+    resource.name.resize(std::max(name_length, 1));
+    glGetProgramResourceName(program, interface, i, name_length, nullptr, &resource.name[0]);
+    resource.name.resize(name_length > 0 ? name_length - 1 : 0);
+    resource.hash = fnv1a(resource.name);
+    _resources.push_back(std::move(resource));
+  }
+
+  // at most half full so that probe sequences stay short
+  std::size_t capacity = 8;
+  while (capacity < 4 * _resources.size()) {
+    capacity *= 2;
+  }
+  _slots.assign(capacity, Slot{0, 0});
+  for (std::uint32_t i = 0; i < _resources.size(); ++i) {
+    const auto& name = _resources[i].name;
+    insert(_resources[i].hash, i);
+    if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+      insert(fnv1a(std::string_view{name}.substr(0, name.size() - 3)), i);
+    }
+  }
+}
+
+void ProgramInterface::clear() {
+  _resources.clear();
+  _slots.clear();
+}
+
+std::size_t ProgramInterface::size() const {
+  return _resources.size();
+}
+
+const std::vector<ProgramResource>& ProgramInterface::resources() const {
+  return _resources;
+}
+
+const ProgramResource* ProgramInterface::find(std::uint64_t hash) const {
+  if (_slots.empty()) {
+    return nullptr;
+  }
+  auto mask = _slots.size() - 1;
+  for (auto slot = hash & mask; _slots[slot].resource != 0; slot = (slot + 1) & mask) {
+    if (_slots[slot].hash == hash) {
+      return &_resources[_slots[slot].resource - 1];
+    }
+  }
+  return nullptr;
+}
+
+const ProgramResource* ProgramInterface::find(std::string_view name) const {
+  return find(fnv1a(name));
+}
+
+void ProgramInterface::insert(std::uint64_t hash, std::uint32_t resource) {
+  auto mask = _slots.size() - 1;
+  auto slot = hash & mask;
+  while (_slots[slot].resource != 0) {
+    if (_slots[slot].hash == hash) {
+      spdlog::warn("Program resources '{}' and '{}' have the same name hash",
+                   _resources[_slots[slot].resource - 1].name, _resources[resource].name);
+      return;
+    }
+    slot = (slot + 1) & mask;
+  }
+  _slots[slot] = Slot{hash, resource + 1};
+}
+
+}  // namespace broom
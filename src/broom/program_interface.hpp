@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/hash.hpp>
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// An active uniform, uniform block, shader storage block or vertex attribute of a linked program.
+// Fields that do not apply to the interface are -1.
+struct ProgramResource {
+  std::string name;
+  std::uint64_t hash;
+  GLuint index;
+  GLenum type;
+  GLint location;
+  GLint array_size;
+  GLint binding;
+  GLint data_size;
+};
+
+// The resources of one program interface, e.g. GL_UNIFORM, queried once after linking.
+//
+// Lookups go through a flat open addressing table of name hashes, with names hashed at compile time
+// through "name"_hash they neither touch strings nor the driver. Array uniforms are found by their
+// name with and without the "[0]" suffix.
+class ProgramInterface {
+ public:
+  ProgramInterface();
+
+  // replaces the resources with the ones active in the linked program
+  void reflect(GLuint program, GLenum interface);
+  void clear();
+
+  std::size_t size() const;
+  const std::vector<ProgramResource>& resources() const;
+  // null if no active resource has that name
+  const ProgramResource* find(std::uint64_t hash) const;
+  const ProgramResource* find(std::string_view name) const;
+
+ protected:
+  struct Slot {
+    std::uint64_t hash;
+    // resource index + 1, 0 marks an empty slot
+    std::uint32_t resource;
+  };
+
+  void insert(std::uint64_t hash, std::uint32_t resource);
+
+ protected:
+  std::vector<ProgramResource> _resources;
+  // the size is a power of two
+  std::vector<Slot> _slots;
+};
+
+}  // namespace broom
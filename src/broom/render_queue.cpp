@@ -0,0 +1,155 @@
+#include <broom/render_queue.hpp>
+
+#include <algorithm>
+
+namespace broom {
+
+RenderQueue::RenderQueue() : _statistics{0, 0, 0} {}
+
+std::uint64_t RenderQueue::sort_key(const DrawCommand& command) {
+  // the most expensive state change occupies the most significant bits, names are truncated to 16 bits,
+  // a collision only costs an extra state change as merging compares the full commands
+  std::uint64_t textures = 0;
+  for (std::size_t i = 0; i < DrawCommand::max_textures; ++i) {
+    textures ^= static_cast<std::uint64_t>(command.textures[i]) << (4 * i);
+  }
+  return (static_cast<std::uint64_t>(command.program & 0xFFFF) << 48) |
+         (static_cast<std::uint64_t>(command.vertex_array & 0xFFFF) << 32) | ((textures & 0xFFFF) << 16) |
+         command.depth;
+}
+
+std::size_t RenderQueue::size() const {
+  return _commands.size();
+}
+
+bool RenderQueue::empty() const {
+  return _commands.empty();
+}
+
+const RenderQueueStatistics& RenderQueue::statistics() const {
+  return _statistics;
+}
+
+void RenderQueue::reserve(std::size_t size) {
+  _commands.reserve(size);
+  _keys.reserve(size);
+  _order.reserve(size);
+  _sorted_keys.reserve(size);
+  _sorted_order.reserve(size);
+}
+
+void RenderQueue::push(const DrawCommand& command) {
+  _keys.push_back(sort_key(command));
+  _order.push_back(static_cast<std::uint32_t>(_commands.size()));
+  _commands.push_back(command);
+}
+
+void RenderQueue::clear() {
+  _commands.clear();
+  _keys.clear();
+  _order.clear();
+}
+
+void RenderQueue::submit() {
+  _statistics = RenderQueueStatistics{_commands.size(), 0, 0};
+  if (_commands.empty()) {
+    return;
+  }
+
+  sort();
+
+  auto pending = _commands[_order[0]];
+  for (std::size_t i = 1; i < _order.size(); ++i) {
+    const auto& command = _commands[_order[i]];
+    if (can_merge(pending, command)) {
+      pending.count += command.count;
+      ++_statistics.merged;
+      continue;
+    }
+    execute(pending);
+    pending = command;
+  }
+  execute(pending);
+
+  clear();
+}
+
+void RenderQueue::sort() {
+  // least significant digit radix sort on bytes, each pass is stable so that it keeps the order of the
+  // previous passes, equal keys are reordered by range afterwards
+  auto count = _keys.size();
+  _sorted_keys.resize(count);
+  _sorted_order.resize(count);
+
+  for (unsigned int shift = 0; shift < 64; shift += 8) {
+    std::array<std::size_t, 256> offsets{};
+    for (auto key : _keys) {
+      ++offsets[(key >> shift) & 0xFF];
+    }
+    // all keys share this byte, the pass would not move anything
+    if (offsets[(_keys[0] >> shift) & 0xFF] == count) {
+      continue;
+    }
+
+    std::size_t sum = 0;
+    for (auto& offset : offsets) {
+      auto bucket_size = offset;
+      offset = sum;
+      sum += bucket_size;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      auto destination = offsets[(_keys[i] >> shift) & 0xFF]++;
+      _sorted_keys[destination] = _keys[i];
+      _sorted_order[destination] = _order[i];
+    }
+    _keys.swap(_sorted_keys);
+    _order.swap(_sorted_order);
+  }
+
+  // draws with identical keys may be drawn in any order, ordering them by range lets more of them merge
+  auto by_first = [this](std::uint32_t lhs, std::uint32_t rhs) { return _commands[lhs].first < _commands[rhs].first; };
+  for (std::size_t begin = 0, end = 1; begin < count; begin = end++) {
+    while (end < count && _keys[end] == _keys[begin]) {
+      ++end;
+    }
+    if (end - begin > 1 && !std::is_sorted(_order.begin() + begin, _order.begin() + end, by_first)) {
+      std::sort(_order.begin() + begin, _order.begin() + end, by_first);
+    }
+  }
+}
+
+void RenderQueue::execute(const DrawCommand& command) {
+  auto& state = StateCache::current();
+  state.use_program(command.program);
+  state.bind_vertex_array(command.vertex_array);
+  for (GLuint unit = 0; unit < DrawCommand::max_textures; ++unit) {
+    if (command.textures[unit] != 0) {
+      state.bind_texture_unit(unit, command.textures[unit]);
+    }
+  }
+  if (command.uniform_buffer != 0) {
+    state.bind_buffer_range(GL_UNIFORM_BUFFER, uniform_binding, command.uniform_buffer, command.uniform_offset,
+                            command.uniform_size);
+  }
+
+  ++_statistics.draw_calls;
+  if (command.index_type == GL_NONE) {
+    draw_arrays(command.mode, command.first, command.count);
+  } else {
+    draw_elements(command.mode, command.count, command.index_type, command.first, command.base_vertex);
+  }
+}
+
+bool RenderQueue::can_merge(const DrawCommand& first, const DrawCommand& second) {
+  // strips and fans cannot simply be concatenated
+  if (first.mode != GL_TRIANGLES && first.mode != GL_LINES && first.mode != GL_POINTS) {
+    return false;
+  }
+  return first.program == second.program && first.vertex_array == second.vertex_array &&
+         first.textures == second.textures && first.uniform_buffer == second.uniform_buffer &&
+         first.uniform_offset == second.uniform_offset && first.uniform_size == second.uniform_size &&
+         first.mode == second.mode && first.index_type == second.index_type &&
+         first.base_vertex == second.base_vertex && first.first + first.count == second.first;
+}
+
+}  // namespace broom
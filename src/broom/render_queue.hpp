@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/draw.hpp>
+#include <broom/opengl.hpp>
+#include <broom/state_cache.hpp>
+
+namespace broom {
+
+// A single draw, referring to GL objects by name so that it stays a trivially copyable value.
+struct DrawCommand {
+  static constexpr std::size_t max_textures = 4;
+
+  GLuint program;
+  GLuint vertex_array;
+  // bound to texture units 0..max_textures-1, 0 leaves a unit untouched
+  std::array<GLuint, max_textures> textures;
+  // bound to RenderQueue::uniform_binding if uniform_buffer is not 0
+  GLuint uniform_buffer;
+  GLintptr uniform_offset;
+  GLsizeiptr uniform_size;
+
+  GLenum mode;
+  // GL_NONE draws arrays, otherwise the type of the vertex array's element buffer
+  GLenum index_type;
+  // first index or first vertex
+  GLuint first;
+  GLsizei count;
+  GLint base_vertex;
+  // orders draws that share all state, e.g. front to back, draws of equal depth may be reordered
+  std::uint16_t depth;
+};
+
+struct RenderQueueStatistics {
+  std::size_t submitted;
+  std::size_t draw_calls;
+  std::size_t merged;
+};
+
+// Collects draws and submits them sorted by their state, so that state changes happen as rarely as possible.
+//
+// Draws with equal state, including depth, are not kept in submission order: they are ordered by their
+// first index or vertex so that more of them merge. Give draws whose order matters, e.g. blended ones,
+// distinct depths.
+class RenderQueue {
+ public:
+  static constexpr GLuint uniform_binding = 0;
+
+  RenderQueue();
+  RenderQueue(const RenderQueue&) = delete;
+  RenderQueue(RenderQueue&&) = default;
+
+  RenderQueue& operator=(const RenderQueue& other) = delete;
+  RenderQueue& operator=(RenderQueue&& other) = default;
+
+  static std::uint64_t sort_key(const DrawCommand& command);
+
+  std::size_t size() const;
+  bool empty() const;
+  const RenderQueueStatistics& statistics() const;
+
+  void reserve(std::size_t size);
+  void push(const DrawCommand& command);
+  void clear();
+  // sorts by state, merges adjacent draws of contiguous ranges, draws everything and clears the queue
+  void submit();
+
+ protected:
+  void sort();
+  void execute(const DrawCommand& command);
+  static bool can_merge(const DrawCommand& first, const DrawCommand& second);
+
+ protected:
+  std::vector<DrawCommand> _commands;
+  std::vector<std::uint64_t> _keys;
+  std::vector<std::uint32_t> _order;
+  // scratch space of the radix sort, kept to avoid allocations per frame
+  std::vector<std::uint64_t> _sorted_keys;
+  std::vector<std::uint32_t> _sorted_order;
+  RenderQueueStatistics _statistics;
+};
+
+}  // namespace broom
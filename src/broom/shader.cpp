@@ -45,6 +45,9 @@ Shader Shader::load_from_file(const std::string& filename, GLenum type) {
   if (!shader.load_source_from_file(filename)) {
     throw std::runtime_error("Failed to load shader from file \"" + filename + "\"");
   }
+  if (!shader.compile()) {
+    throw std::runtime_error("Failed to compile shader from file \"" + filename + "\"");
+  }
 
   return shader;
 }
@@ -113,6 +116,17 @@ bool Shader::compile() const {
   return true;
 }
 
+void Shader::compile_async() const {
+  glCompileShader(_id);
+}
+
+bool Shader::completion_status() const {
+  if (!GLAD_GL_KHR_parallel_shader_compile) {
+    return true;
+  }
+  return get_parameter(GL_COMPLETION_STATUS_KHR) != GL_FALSE;
+}
+
 GLint Shader::get_parameter(GLenum parameter) const {
   GLint result;
   glGetShaderiv(_id, parameter, &result);
@@ -125,6 +139,36 @@ void Shader::destroy() const {
   }
 }
 
+std::string load_shader_source(const std::string& filename, const std::vector<std::string>& defines) {
+  std::ifstream filestream{filename};
+  if (!filestream.is_open()) {
+    spdlog::error("Failed to open file \"{}\"", filename);
+    throw std::runtime_error("Failed to open shader source \"" + filename + "\"");
+  }
+  std::string source{std::istreambuf_iterator<char>(filestream), std::istreambuf_iterator<char>()};
+  if (defines.empty()) {
+    return source;
+  }
+
+  std::string lines;
+  for (const auto& define : defines) {
+    lines += "#define " + define + "\n";
+  }
+  // #version has to stay the first statement
+  std::size_t position = 0;
+  auto version = source.find("#version");
+  if (version != std::string::npos) {
+    auto end = source.find('\n', version);
+    if (end == std::string::npos) {
+      source += '\n';
+      end = source.size() - 1;
+    }
+    position = end + 1;
+  }
+  source.insert(position, lines);
+  return source;
+}
+
 GLenum detect_shader_type_from_filename(const std::string& filename) {
   auto file_ending_2 = filename.substr(filename.length() - 2, 2);
   auto file_ending_4 = filename.substr(filename.length() - 4, 4);
@@ -138,6 +182,8 @@ GLenum detect_shader_type_from_filename(const std::string& filename) {
     return GL_GEOMETRY_SHADER;
   } else if (file_ending_4 == "frag" || file_ending_2 == "fs") {
     return GL_FRAGMENT_SHADER;
+  } else if (file_ending_4 == "comp" || file_ending_2 == "cs") {
+    return GL_COMPUTE_SHADER;
   }
   return GL_NONE;
 }
@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
@@ -35,6 +36,10 @@ class Shader {
   void set_source(const std::string& source) const;
   bool load_source_from_file(const std::string& filename) const;
   bool compile() const;
+  // starts compiling without waiting for the result, see completion_status()
+  void compile_async() const;
+  // false while a parallel compile is still running, always true without GL_KHR_parallel_shader_compile
+  bool completion_status() const;
 
  protected:
   GLint get_parameter(GLenum parameter) const;
@@ -46,5 +51,8 @@ class Shader {
 };
 
 GLenum detect_shader_type_from_filename(const std::string& filename);
+// reads a shader's source and inserts a #define line for each define right after the #version directive,
+// e.g. "USE_FOG" or "LIGHT_COUNT 4"
+std::string load_shader_source(const std::string& filename, const std::vector<std::string>& defines = {});
 
 }  // namespace broom
\ No newline at end of file
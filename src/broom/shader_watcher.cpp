@@ -0,0 +1,175 @@
+#include <broom/shader_watcher.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace broom {
+
+ShaderWatcher::ShaderWatcher() : _inotify{-1}, _event{-1} {
+#ifdef __linux__
+  _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  _event = eventfd(0, EFD_CLOEXEC);
+  if (_inotify < 0 || _event < 0) {
+    spdlog::warn("Failed to set up file notifications, shaders will not be reloaded");
+    return;
+  }
+  _thread = std::thread{[this]() { run(); }};
+#else
+  spdlog::warn("File notifications are only implemented with inotify, shaders will not be reloaded");
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher() {
+#ifdef __linux__
+  if (_thread.joinable()) {
+    std::uint64_t value = 1;
+    if (write(_event, &value, sizeof(value)) != sizeof(value)) {
+      spdlog::error("Failed to stop the shader watcher thread");
+    }
+    _thread.join();
+  }
+  if (_inotify >= 0) {
+    close(_inotify);
+  }
+  if (_event >= 0) {
+    close(_event);
+  }
+#endif
+}
+
+bool ShaderWatcher::supported() const {
+  return _thread.joinable();
+}
+
+std::size_t ShaderWatcher::watched() const {
+  return std::count_if(_entries.begin(), _entries.end(), [](const Entry& entry) { return !entry.program.expired(); });
+}
+
+void ShaderWatcher::watch(const std::shared_ptr<Program>& program,
+                          const std::vector<std::string>& filenames,
+                          const std::vector<std::string>& defines) {
+  Entry entry{program, filenames, defines, {}};
+  for (const auto& filename : filenames) {
+    // events name files relative to their directory, so they are matched by absolute paths
+    entry.paths.insert(std::filesystem::weakly_canonical(std::filesystem::absolute(filename)));
+  }
+
+#ifdef __linux__
+  if (supported()) {
+    for (const auto& path : entry.paths) {
+      // editors often save by renaming a new file over the old one, which only shows up on the directory
+      auto directory = path.parent_path();
+      auto descriptor = inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+      if (descriptor < 0) {
+        spdlog::warn("Failed to watch shader directory '{}'", directory.string());
+        continue;
+      }
+      std::lock_guard<std::mutex> lock{_mutex};
+      _directories[descriptor] = directory;
+    }
+  }
+#endif
+
+  spdlog::debug("Watching the {} shaders of program {}", filenames.size(), program->id());
+  _entries.push_back(std::move(entry));
+}
+
+std::size_t ShaderWatcher::update() {
+  std::set<std::filesystem::path> changed;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    changed.swap(_changed);
+  }
+
+  _entries.erase(std::remove_if(_entries.begin(), _entries.end(),
+                                [](const Entry& entry) { return entry.program.expired(); }),
+                 _entries.end());
+  for (const auto& entry : _entries) {
+    if (std::none_of(entry.paths.begin(), entry.paths.end(),
+                     [&](const std::filesystem::path& path) { return changed.count(path) > 0; })) {
+      continue;
+    }
+    auto program = entry.program.lock();
+    // a newer rebuild replaces one still in flight, the older result is dropped once it is done
+    _rebuilds.erase(std::remove_if(_rebuilds.begin(), _rebuilds.end(),
+                                   [&](const Rebuild& rebuild) { return rebuild.program.lock() == program; }),
+                    _rebuilds.end());
+    try {
+      _rebuilds.push_back(Rebuild{program, _compiler.submit(entry.filenames, entry.defines)});
+      spdlog::info("Rebuilding program {} after its shaders changed", program->id());
+    } catch (const std::exception& error) {
+      spdlog::warn("Failed to reload the shaders of program {}: {}", program->id(), error.what());
+    }
+  }
+
+  _compiler.poll();
+  std::size_t swapped = 0;
+  for (auto rebuild = _rebuilds.begin(); rebuild != _rebuilds.end();) {
+    if (!rebuild->build.ready()) {
+      ++rebuild;
+      continue;
+    }
+    auto program = rebuild->program.lock();
+    if (program && rebuild->build.failed()) {
+      spdlog::error("Rebuilding program {} failed, keeping the previous version", program->id());
+    } else if (program) {
+      // bindings set through set_*_block_binding() carry over to the blocks that still exist, the old
+      // program object is deleted along with the build
+      auto& rebuilt = *rebuild->build.program();
+      for (const auto& block : program->uniform_blocks().resources()) {
+        rebuilt.set_uniform_block_binding(block.hash, block.binding);
+      }
+      for (const auto& block : program->storage_blocks().resources()) {
+        rebuilt.set_storage_block_binding(block.hash, block.binding);
+      }
+      program->swap(rebuilt);
+      spdlog::info("Reloaded program {}", program->id());
+      ++swapped;
+    }
+    rebuild = _rebuilds.erase(rebuild);
+  }
+  return swapped;
+}
+
+void ShaderWatcher::run() {
+#ifdef __linux__
+  alignas(inotify_event) char buffer[16 * 1024];
+  pollfd descriptors[2] = {{_inotify, POLLIN, 0}, {_event, POLLIN, 0}};
+  while (true) {
+    if (::poll(descriptors, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      spdlog::error("Waiting for shader file changes failed, shaders will not be reloaded");
+      return;
+    }
+    if (descriptors[1].revents != 0) {
+      return;
+    }
+
+    auto length = read(_inotify, buffer, sizeof(buffer));
+    if (length <= 0) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock{_mutex};
+    for (auto position = buffer; position < buffer + length;) {
+      auto event = reinterpret_cast<const inotify_event*>(position);
+      auto directory = _directories.find(event->wd);
+      if (event->len > 0 && directory != _directories.end()) {
+        _changed.insert(directory->second / event->name);
+      }
+      position += sizeof(inotify_event) + event->len;
+    }
+  }
+#endif
+}
+
+}  // namespace broom
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/program.hpp>
+#include <broom/program_compiler.hpp>
+
+namespace broom {
+
+// Rebuilds programs when their shader files change on disk, for iterating on shaders without restarting.
+//
+// A background thread waits for inotify events on the directories of the watched files. update() submits
+// the affected programs to a ProgramCompiler and, once a rebuild links, swaps the new program object into
+// the watched Program, so handles to it stay valid. Failed rebuilds keep the previous program. The new
+// program starts with default uniform values, they have to be set again after a swap. Uniform and storage
+// block bindings are copied from the old program for every block that is still active.
+class ShaderWatcher {
+ public:
+  ShaderWatcher();
+  ShaderWatcher(const ShaderWatcher&) = delete;
+  ShaderWatcher(ShaderWatcher&&) = delete;
+  ~ShaderWatcher();
+
+  ShaderWatcher& operator=(const ShaderWatcher& other) = delete;
+  ShaderWatcher& operator=(ShaderWatcher&& other) = delete;
+
+  // false if file notifications are not available, watching then does nothing
+  bool supported() const;
+  // number of programs still alive and watched
+  std::size_t watched() const;
+
+  // the program is rebuilt from the given files and defines, it stops being watched once it is destroyed
+  void watch(const std::shared_ptr<Program>& program,
+             const std::vector<std::string>& filenames,
+             const std::vector<std::string>& defines = {});
+  // call once per frame outside of the draws, returns the number of programs that were swapped
+  std::size_t update();
+
+ protected:
+  struct Entry {
+    std::weak_ptr<Program> program;
+    std::vector<std::string> filenames;
+    std::vector<std::string> defines;
+    std::set<std::filesystem::path> paths;
+  };
+  struct Rebuild {
+    std::weak_ptr<Program> program;
+    ProgramBuild build;
+  };
+
+  void run();
+
+ protected:
+  int _inotify;
+  // wakes the thread up for shutdown
+  int _event;
+  std::vector<Entry> _entries;
+  std::vector<Rebuild> _rebuilds;
+  ProgramCompiler _compiler;
+
+  // shared with the thread
+  mutable std::mutex _mutex;
+  std::unordered_map<int, std::filesystem::path> _directories;
+  std::set<std::filesystem::path> _changed;
+  std::thread _thread;
+};
+
+}  // namespace broom
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace broom {
+
+// Non-owning view of contiguous elements, a subset of C++20's std::span.
+template <typename T>
+class Span {
+ public:
+  using element_type = T;
+
+  constexpr Span() : _data{nullptr}, _size{0} {}
+  constexpr Span(T* data, std::size_t size) : _data{data}, _size{size} {}
+  template <std::size_t N>
+  constexpr Span(T (&array)[N]) : _data{array}, _size{N} {}
+  template <typename U, std::size_t N>
+  constexpr Span(std::array<U, N>& array) : _data{array.data()}, _size{N} {}
+  template <typename U, std::size_t N>
+  constexpr Span(const std::array<U, N>& array) : _data{array.data()}, _size{N} {}
+  template <typename U>
+  Span(std::vector<U>& vector) : _data{vector.data()}, _size{vector.size()} {}
+  template <typename U>
+  Span(const std::vector<U>& vector) : _data{vector.data()}, _size{vector.size()} {}
+
+  constexpr T* data() const { return _data; }
+  constexpr std::size_t size() const { return _size; }
+  constexpr std::size_t size_bytes() const { return _size * sizeof(T); }
+  constexpr bool empty() const { return _size == 0; }
+
+  constexpr T* begin() const { return _data; }
+  constexpr T* end() const { return _data + _size; }
+  constexpr T& operator[](std::size_t index) const { return _data[index]; }
+
+  constexpr Span subspan(std::size_t offset, std::size_t count) const { return Span{_data + offset, count}; }
+
+ protected:
+  T* _data;
+  std::size_t _size;
+};
+
+}  // namespace broom
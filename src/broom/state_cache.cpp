@@ -0,0 +1,279 @@
+#include <broom/state_cache.hpp>
+
+namespace broom {
+
+StateCache::StateCache() : _counters{0, 0} {
+  invalidate();
+}
+
+StateCache& StateCache::current() {
+  static thread_local StateCache cache;
+  return cache;
+}
+
+const StateCounters& StateCache::counters() const {
+  return _counters;
+}
+
+void StateCache::reset_counters() {
+  _counters = StateCounters{0, 0};
+}
+
+void StateCache::invalidate() {
+  _program = unknown;
+  _vertex_array = unknown;
+  _active_texture = unknown;
+  _buffers.fill(unknown);
+  _textures.fill(unknown);
+  _uniform_buffers.fill(BufferRange{unknown, 0, 0});
+  _storage_buffers.fill(BufferRange{unknown, 0, 0});
+  _capabilities.fill(unknown);
+  _blend_source = unknown;
+  _blend_destination = unknown;
+  _depth_func = unknown;
+  _depth_mask = unknown;
+  _unpack_alignment = unknown;
+}
+
+void StateCache::set_defaults() {
+  _program = 0;
+  _vertex_array = 0;
+  _active_texture = 0;
+  _buffers.fill(0);
+  _textures.fill(0);
+  _uniform_buffers.fill(BufferRange{0, 0, 0});
+  _storage_buffers.fill(BufferRange{0, 0, 0});
+  _capabilities.fill(GL_FALSE);
+  _blend_source = GL_ONE;
+  _blend_destination = GL_ZERO;
+  _depth_func = GL_LESS;
+  _depth_mask = GL_TRUE;
+  _unpack_alignment = 4;
+}
+
+void StateCache::use_program(GLuint program) {
+  if (changed(_program, program)) {
+    glUseProgram(program);
+  }
+}
+
+void StateCache::bind_vertex_array(GLuint vertex_array) {
+  if (changed(_vertex_array, vertex_array)) {
+    glBindVertexArray(vertex_array);
+    // the element buffer binding is part of the vertex array state
+    _buffers[buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+  }
+}
+
+void StateCache::bind_buffer(GLenum target, GLuint buffer) {
+  auto index = buffer_target_index(target);
+  if (index < 0 || changed(_buffers[index], buffer)) {
+    if (index < 0) {
+      ++_counters.issued;
+    }
+    glBindBuffer(target, buffer);
+  }
+}
+
+void StateCache::bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+  BufferRange* cached = nullptr;
+  if (index < max_indexed_buffers) {
+    if (target == GL_UNIFORM_BUFFER) {
+      cached = &_uniform_buffers[index];
+    } else if (target == GL_SHADER_STORAGE_BUFFER) {
+      cached = &_storage_buffers[index];
+    }
+  }
+  if (cached && cached->buffer == buffer && cached->offset == offset && cached->size == size) {
+    ++_counters.skipped;
+    return;
+  }
+  ++_counters.issued;
+  if (cached) {
+    *cached = BufferRange{buffer, offset, size};
+  }
+  glBindBufferRange(target, index, buffer, offset, size);
+
+  // binding an indexed range also changes the generic binding point of the target
+  auto target_index = buffer_target_index(target);
+  if (target_index >= 0) {
+    _buffers[target_index] = buffer;
+  }
+}
+
+void StateCache::bind_texture(GLenum target, GLuint texture) {
+  if (_active_texture >= max_texture_units) {
+    ++_counters.issued;
+    glBindTexture(target, texture);
+    return;
+  }
+  if (changed(_textures[_active_texture], texture)) {
+    glBindTexture(target, texture);
+    if (texture == 0) {
+      // only unbinds the given target, textures of other targets may still be bound to the unit
+      _textures[_active_texture] = unknown;
+    }
+  }
+}
+
+void StateCache::bind_texture_unit(GLuint unit, GLuint texture) {
+  if (unit >= max_texture_units) {
+    ++_counters.issued;
+    glBindTextureUnit(unit, texture);
+    return;
+  }
+  if (changed(_textures[unit], texture)) {
+    glBindTextureUnit(unit, texture);
+  }
+}
+
+void StateCache::set_active_texture(GLuint unit) {
+  if (changed(_active_texture, unit)) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+}
+
+void StateCache::set_enabled(GLenum capability, bool enabled) {
+  auto index = capability_index(capability);
+  if (index < 0 || changed(_capabilities[index], enabled)) {
+    if (index < 0) {
+      ++_counters.issued;
+    }
+    if (enabled) {
+      glEnable(capability);
+    } else {
+      glDisable(capability);
+    }
+  }
+}
+
+void StateCache::set_blend_func(GLenum source_factor, GLenum destination_factor) {
+  if (_blend_source == source_factor && _blend_destination == destination_factor) {
+    ++_counters.skipped;
+    return;
+  }
+  ++_counters.issued;
+  _blend_source = source_factor;
+  _blend_destination = destination_factor;
+  glBlendFunc(source_factor, destination_factor);
+}
+
+void StateCache::set_depth_func(GLenum func) {
+  if (changed(_depth_func, func)) {
+    glDepthFunc(func);
+  }
+}
+
+void StateCache::set_depth_mask(bool enabled) {
+  if (changed(_depth_mask, enabled)) {
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+  }
+}
+
+void StateCache::set_unpack_alignment(GLint alignment) {
+  if (changed(_unpack_alignment, alignment)) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+  }
+}
+
+void StateCache::forget_program(GLuint program) {
+  // a deleted program stays in use until another one is used
+  if (_program == program) {
+    _program = unknown;
+  }
+}
+
+void StateCache::forget_vertex_array(GLuint vertex_array) {
+  if (_vertex_array == vertex_array) {
+    _vertex_array = 0;
+    _buffers[buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)] = 0;
+  }
+}
+
+void StateCache::forget_buffer(GLuint buffer) {
+  for (auto& binding : _buffers) {
+    if (binding == buffer) {
+      binding = 0;
+    }
+  }
+  for (auto& range : _uniform_buffers) {
+    if (range.buffer == buffer) {
+      range = BufferRange{0, 0, 0};
+    }
+  }
+  for (auto& range : _storage_buffers) {
+    if (range.buffer == buffer) {
+      range = BufferRange{0, 0, 0};
+    }
+  }
+}
+
+void StateCache::forget_texture(GLuint texture) {
+  for (auto& binding : _textures) {
+    if (binding == texture) {
+      binding = 0;
+    }
+  }
+}
+
+int StateCache::buffer_target_index(GLenum target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      return 0;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return 1;
+    case GL_UNIFORM_BUFFER:
+      return 2;
+    case GL_SHADER_STORAGE_BUFFER:
+      return 3;
+    case GL_DRAW_INDIRECT_BUFFER:
+      return 4;
+    case GL_DISPATCH_INDIRECT_BUFFER:
+      return 5;
+    case GL_PIXEL_PACK_BUFFER:
+      return 6;
+    case GL_PIXEL_UNPACK_BUFFER:
+      return 7;
+    case GL_COPY_READ_BUFFER:
+      return 8;
+    case GL_COPY_WRITE_BUFFER:
+      return 9;
+    case GL_ATOMIC_COUNTER_BUFFER:
+      return 10;
+    case GL_QUERY_BUFFER:
+      return 11;
+  }
+  return -1;
+}
+
+int StateCache::capability_index(GLenum capability) {
+  switch (capability) {
+    case GL_BLEND:
+      return 0;
+    case GL_DEPTH_TEST:
+      return 1;
+    case GL_CULL_FACE:
+      return 2;
+    case GL_SCISSOR_TEST:
+      return 3;
+    case GL_STENCIL_TEST:
+      return 4;
+    case GL_FRAMEBUFFER_SRGB:
+      return 5;
+    case GL_PRIMITIVE_RESTART:
+      return 6;
+  }
+  return -1;
+}
+
+bool StateCache::changed(GLuint& cached, GLuint value) {
+  if (cached == value) {
+    ++_counters.skipped;
+    return false;
+  }
+  ++_counters.issued;
+  cached = value;
+  return true;
+}
+
+}  // namespace broom
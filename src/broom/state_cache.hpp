@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+struct StateCounters {
+  std::uint64_t issued;
+  std::uint64_t skipped;
+};
+
+// Shadows the bindings of the current context and drops calls that would not change them.
+// Anything that changes GL state without going through this cache must call invalidate().
+class StateCache {
+ public:
+  static constexpr GLuint unknown = std::numeric_limits<GLuint>::max();
+  static constexpr std::size_t max_texture_units = 32;
+  static constexpr std::size_t max_indexed_buffers = 16;
+
+  StateCache();
+  StateCache(const StateCache&) = delete;
+  StateCache(StateCache&&) = delete;
+
+  StateCache& operator=(const StateCache& other) = delete;
+  StateCache& operator=(StateCache&& other) = delete;
+
+  // one cache per thread, as GL contexts are made current per thread
+  static StateCache& current();
+
+  const StateCounters& counters() const;
+  void reset_counters();
+  void invalidate();
+  // assume the default state of a freshly created context
+  void set_defaults();
+
+  // bindings
+  void use_program(GLuint program);
+  void bind_vertex_array(GLuint vertex_array);
+  void bind_buffer(GLenum target, GLuint buffer);
+  void bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+  void bind_texture(GLenum target, GLuint texture);
+  void bind_texture_unit(GLuint unit, GLuint texture);
+  void set_active_texture(GLuint unit);
+
+  // fixed function state
+  void set_enabled(GLenum capability, bool enabled);
+  void set_blend_func(GLenum source_factor, GLenum destination_factor);
+  void set_depth_func(GLenum func);
+  void set_depth_mask(bool enabled);
+  void set_unpack_alignment(GLint alignment);
+
+  // deleting an object implicitly unbinds it from the current context
+  void forget_program(GLuint program);
+  void forget_vertex_array(GLuint vertex_array);
+  void forget_buffer(GLuint buffer);
+  void forget_texture(GLuint texture);
+
+ protected:
+  static constexpr std::size_t buffer_target_count = 12;
+  static constexpr std::size_t capability_count = 7;
+
+  struct BufferRange {
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+
+  static int buffer_target_index(GLenum target);
+  static int capability_index(GLenum capability);
+
+  bool changed(GLuint& cached, GLuint value);
+
+ protected:
+  StateCounters _counters;
+  GLuint _program;
+  GLuint _vertex_array;
+  GLuint _active_texture;
+  std::array<GLuint, buffer_target_count> _buffers;
+  std::array<GLuint, max_texture_units> _textures;
+  std::array<BufferRange, max_indexed_buffers> _uniform_buffers;
+  std::array<BufferRange, max_indexed_buffers> _storage_buffers;
+  std::array<GLuint, capability_count> _capabilities;
+  GLuint _blend_source;
+  GLuint _blend_destination;
+  GLuint _depth_func;
+  GLuint _depth_mask;
+  GLuint _unpack_alignment;
+};
+
+}  // namespace broom
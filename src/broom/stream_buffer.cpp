@@ -0,0 +1,109 @@
+#include <broom/stream_buffer.hpp>
+
+namespace broom {
+
+StreamBuffer::StreamBuffer(GLsizeiptr region_size, unsigned int regions)
+    : _fences(regions, nullptr),
+      _region_size{region_size},
+      _regions{regions},
+      _region{0},
+      _head{0},
+      _stalls{0} {
+  if (regions == 0 || region_size <= 0) {
+    throw std::runtime_error("A stream buffer needs at least one non-empty region");
+  }
+
+  // immutable storage is required for persistent mapping, the mapping stays valid for the buffer's lifetime
+  GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  _buffer.set_storage(_region_size * _regions, nullptr, flags);
+  _mapping = _buffer.map_range<std::uint8_t>(0, _region_size * _regions, flags);
+  spdlog::debug("Created stream buffer {} with {} regions of {} bytes", _buffer.id(), _regions, _region_size);
+}
+
+StreamBuffer::~StreamBuffer() {
+  destroy();
+}
+
+const Buffer& StreamBuffer::buffer() const {
+  return _buffer;
+}
+
+GLsizeiptr StreamBuffer::region_size() const {
+  return _region_size;
+}
+
+unsigned int StreamBuffer::regions() const {
+  return _regions;
+}
+
+unsigned int StreamBuffer::current_region() const {
+  return _region;
+}
+
+GLsizeiptr StreamBuffer::available() const {
+  return _region_size - _head;
+}
+
+std::size_t StreamBuffer::stalls() const {
+  return _stalls;
+}
+
+StreamAllocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+  // align the absolute offset, regions themselves need not be aligned
+  GLintptr region_begin = _region * _region_size;
+  GLintptr offset = (region_begin + _head + alignment - 1) / alignment * alignment;
+  if (offset + size > region_begin + _region_size) {
+    spdlog::error("Stream buffer {} cannot fit {} more bytes into a region of {} bytes", _buffer.id(), size,
+                  _region_size);
+    throw std::runtime_error("Stream buffer region exhausted!");
+  }
+  _head = offset + size - region_begin;
+  return StreamAllocation{_mapping.data() + offset, offset, size};
+}
+
+void StreamBuffer::next_frame() {
+  if (_fences[_region]) {
+    glDeleteSync(_fences[_region]);
+  }
+  _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  _region = (_region + 1) % _regions;
+  _head = 0;
+  wait(_region);
+}
+
+void StreamBuffer::wait(unsigned int region) {
+  auto fence = _fences[region];
+  if (!fence) {
+    return;
+  }
+
+  // only flush and block if the GPU has not yet caught up
+  auto result = glClientWaitSync(fence, 0, 0);
+  if (result == GL_TIMEOUT_EXPIRED) {
+    ++_stalls;
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    do {
+      result = glClientWaitSync(fence, flags, 1000000000);
+      flags = 0;
+    } while (result == GL_TIMEOUT_EXPIRED);
+  }
+  if (result == GL_WAIT_FAILED) {
+    spdlog::error("Waiting for region {} of stream buffer {} failed", region, _buffer.id());
+  }
+
+  glDeleteSync(fence);
+  _fences[region] = nullptr;
+}
+
+void StreamBuffer::destroy() {
+  for (auto& fence : _fences) {
+    if (fence) {
+      glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  _mapping.unmap();
+}
+
+}  // namespace broom
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/buffer.hpp>
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+struct StreamAllocation {
+  void* data;
+  GLintptr offset;
+  GLsizeiptr size;
+};
+
+// A persistently and coherently mapped buffer split into one region per frame in flight.
+// The CPU writes the current region while the GPU reads the previous ones, fences keep it
+// from overwriting a region before the GPU has finished with it.
+class StreamBuffer {
+ public:
+  StreamBuffer(GLsizeiptr region_size, unsigned int regions = 3);
+  StreamBuffer(const StreamBuffer&) = delete;
+  StreamBuffer(StreamBuffer&&) = delete;
+  ~StreamBuffer();
+
+  StreamBuffer& operator=(const StreamBuffer& other) = delete;
+  StreamBuffer& operator=(StreamBuffer&& other) = delete;
+
+  const Buffer& buffer() const;
+  GLsizeiptr region_size() const;
+  unsigned int regions() const;
+  unsigned int current_region() const;
+  // bytes still free in the current region
+  GLsizeiptr available() const;
+  // number of times next_frame() had to wait for the GPU
+  std::size_t stalls() const;
+
+  // offsets are relative to the start of the whole buffer, ready to be used for binding or drawing
+  StreamAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 1);
+  template <typename T>
+  StreamAllocation write(const T* data, std::size_t count, GLsizeiptr alignment = alignof(T)) {
+    auto allocation = allocate(sizeof(T) * count, alignment);
+    std::memcpy(allocation.data, data, sizeof(T) * count);
+    return allocation;
+  }
+  template <typename T>
+  StreamAllocation write(const std::vector<T>& vector, GLsizeiptr alignment = alignof(T)) {
+    return write(vector.data(), vector.size(), alignment);
+  }
+
+  // fences the commands using the current region and moves on to the next one
+  void next_frame();
+
+ protected:
+  void wait(unsigned int region);
+  void destroy();
+
+ protected:
+  Buffer _buffer;
+  BufferMapping<std::uint8_t> _mapping;
+  std::vector<GLsync> _fences;
+  GLsizeiptr _region_size;
+  unsigned int _regions;
+  unsigned int _region;
+  GLsizeiptr _head;
+  std::size_t _stalls;
+};
+
+}  // namespace broom
@@ -1,17 +1,70 @@
 #include <broom/texture.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
 
 namespace broom {
 
-Texture::Texture() {
-  glCreateTextures(GL_TEXTURE_2D, 1, &_id);
+GLsizeiptr pixel_size(GLenum format, GLenum type) {
+  GLsizeiptr components = 0;
+  switch (format) {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT:
+    case GL_STENCIL_INDEX:
+      components = 1;
+      break;
+    case GL_RG:
+    case GL_RG_INTEGER:
+      components = 2;
+      break;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER:
+      components = 3;
+      break;
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_RGBA_INTEGER:
+      components = 4;
+      break;
+  }
+
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+      return components;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+      return components * 2;
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT:
+      return components * 4;
+    // packed types hold a whole pixel
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+      return 2;
+    case GL_UNSIGNED_INT_8_8_8_8:
+    case GL_UNSIGNED_INT_8_8_8_8_REV:
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_24_8:
+      return 4;
+  }
+  return 0;
 }
 
-Texture::Texture(const Texture& other) : _owner{false}, _id{other._id} {}
+Texture::Texture(GLenum target) : _owner{true}, _target{target} {
+  glCreateTextures(target, 1, &_id);
+}
+
+Texture::Texture(const Texture& other) : _owner{false}, _target{other._target}, _id{other._id} {}
 
-Texture::Texture(Texture&& other) : _owner{other._owner}, _id{other._id} {
+Texture::Texture(Texture&& other) : _owner{other._owner}, _target{other._target}, _id{other._id} {
   other._owner = false;
 }
 
@@ -22,6 +75,7 @@ Texture::~Texture() {
 Texture& Texture::operator=(const Texture& other) {
   destroy();
   _owner = false;
+  _target = other._target;
   _id = other._id;
   return *this;
 }
@@ -30,22 +84,84 @@ Texture& Texture::operator=(Texture&& other) {
   destroy();
   _owner = other._owner;
   other._owner = false;
+  _target = other._target;
   _id = other._id;
   return *this;
 }
 
-Texture Texture::load_from_file(const std::string& filename) {
+Texture Texture::load_from_file(const std::string& filename, bool mipmaps, bool srgb, ThreadPool* pool) {
   Texture texture;
-  if (!texture.load_image_from_file(filename)) {
+  if (!texture.load_image_from_file(filename, mipmaps, srgb, pool)) {
     throw std::runtime_error("Failed to load texture from file \"" + filename + "\"");
   }
   return texture;
 }
 
+std::vector<Texture> Texture::load_from_files(const std::vector<std::string>& filenames,
+                                              ThreadPool& pool,
+                                              bool mipmaps,
+                                              bool srgb) {
+  // each task builds the mip chain of its image, spreading the larger levels over the pool as well
+  std::vector<std::future<std::vector<Image>>> images(filenames.size());
+  std::vector<std::future<CompressedImage>> compressed_images(filenames.size());
+  for (std::size_t i = 0; i < filenames.size(); ++i) {
+    auto filename = filenames[i];
+    if (CompressedImage::is_compressed_file(filename)) {
+      compressed_images[i] = pool.submit([filename]() { return CompressedImage::load_from_file(filename); });
+    } else {
+      images[i] = pool.submit([filename, mipmaps, srgb, &pool]() {
+        auto image = Image::load_from_file(filename, true);
+        return mipmaps ? image.mip_chain(srgb, &pool) : std::vector<Image>{std::move(image)};
+      });
+    }
+  }
+
+  auto ready = [&](std::size_t i, std::chrono::milliseconds timeout) {
+    auto status = compressed_images[i].valid() ? compressed_images[i].wait_for(timeout) : images[i].wait_for(timeout);
+    return status == std::future_status::ready;
+  };
+
+  // uploads in the order the tasks finish, so one large image does not hold back the ones behind it
+  std::vector<Texture> textures(filenames.size());
+  std::vector<std::size_t> pending(filenames.size());
+  std::iota(pending.begin(), pending.end(), 0);
+  while (!pending.empty()) {
+    auto next = std::find_if(pending.begin(), pending.end(),
+                             [&](std::size_t i) { return ready(i, std::chrono::milliseconds{0}); });
+    if (next == pending.end()) {
+      ready(pending.front(), std::chrono::milliseconds{1});
+      continue;
+    }
+    auto i = *next;
+    pending.erase(next);
+    try {
+      if (compressed_images[i].valid()) {
+        textures[i].load_compressed_image(compressed_images[i].get());
+      } else {
+        textures[i].load_mip_chain(images[i].get());
+      }
+    } catch (const std::exception& error) {
+      // the other files still load, this texture is left invalid
+      spdlog::error("Failed to load texture from file \"{}\": {}", filenames[i], error.what());
+      textures[i].destroy();
+      textures[i]._id = 0;
+    }
+  }
+  return textures;
+}
+
+bool Texture::valid() const {
+  return glIsTexture(_id) != GL_FALSE;
+}
+
 GLuint Texture::id() const {
   return _id;
 }
 
+GLenum Texture::target() const {
+  return _target;
+}
+
 GLenum Texture::format() const {
   return get_int_level_paremeter(GL_TEXTURE_INTERNAL_FORMAT);
 }
@@ -58,6 +174,10 @@ unsigned int Texture::height(GLuint level) const {
   return get_int_level_paremeter(GL_TEXTURE_HEIGHT, level);
 }
 
+unsigned int Texture::depth(GLuint level) const {
+  return get_int_level_paremeter(GL_TEXTURE_DEPTH, level);
+}
+
 glm::uvec2 Texture::size() const {
   return glm::uvec2{this->width(), this->height()};
 }
@@ -66,20 +186,47 @@ bool Texture::has_alpha() const {
   return get_int_level_paremeter(GL_TEXTURE_ALPHA_SIZE) > 0;
 }
 
+bool Texture::compressed() const {
+  return get_int_level_paremeter(GL_TEXTURE_COMPRESSED) != GL_FALSE;
+}
+
+std::size_t Texture::memory_size() const {
+  auto levels = std::max(1, get_int_parameter(GL_TEXTURE_IMMUTABLE_LEVELS));
+  std::size_t size = 0;
+  for (GLint level = 0; level < levels; ++level) {
+    if (get_int_level_paremeter(GL_TEXTURE_COMPRESSED, level)) {
+      // covers all layers of an array texture
+      size += get_int_level_paremeter(GL_TEXTURE_COMPRESSED_IMAGE_SIZE, level);
+      continue;
+    }
+    std::size_t bits = 0;
+    for (auto parameter : {GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE,
+                           GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE}) {
+      bits += get_int_level_paremeter(parameter, level);
+    }
+    size += std::size_t{width(level)} * height(level) * depth(level) * bits / 8;
+  }
+  return size;
+}
+
 void Texture::bind() const {
-  glBindTexture(GL_TEXTURE_2D, _id);
+  StateCache::current().bind_texture(_target, _id);
 }
 
-void Texture::unbind() {
-  glBindTexture(GL_TEXTURE_2D, 0);
+void Texture::unbind(GLenum target) {
+  StateCache::current().bind_texture(target, 0);
 }
 
 void Texture::bind_unit(GLuint unit) const {
-  glBindTextureUnit(unit, _id);
+  StateCache::current().bind_texture_unit(unit, _id);
+}
+
+void Texture::bind_image(GLuint unit, GLenum access, GLenum format, GLint level, GLint layer) const {
+  glBindImageTexture(unit, _id, level, layer < 0 ? GL_TRUE : GL_FALSE, layer < 0 ? 0 : layer, access, format);
 }
 
 void Texture::set_active(GLenum unit) {
-  glActiveTexture(GL_TEXTURE0 + unit);
+  StateCache::current().set_active_texture(unit);
 }
 
 void Texture::generate_mipmap() {
@@ -110,6 +257,10 @@ void Texture::set_storage(GLsizei levels, GLenum internal_format, GLsizei width,
   glTextureStorage2D(_id, levels, internal_format, width, height);
 }
 
+void Texture::set_storage(GLsizei levels, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth) {
+  glTextureStorage3D(_id, levels, internal_format, width, height, depth);
+}
+
 void Texture::set_sub_image(GLint level,
                             GLint x,
                             GLint y,
@@ -121,6 +272,30 @@ void Texture::set_sub_image(GLint level,
   glTextureSubImage2D(_id, level, x, y, width, height, format, type, data);
 }
 
+void Texture::set_sub_image(GLint level,
+                            GLint x,
+                            GLint y,
+                            GLint z,
+                            GLsizei width,
+                            GLsizei height,
+                            GLsizei depth,
+                            GLenum format,
+                            GLenum type,
+                            const void* data) {
+  glTextureSubImage3D(_id, level, x, y, z, width, height, depth, format, type, data);
+}
+
+void Texture::set_compressed_sub_image(GLint level,
+                                       GLint x,
+                                       GLint y,
+                                       GLsizei width,
+                                       GLsizei height,
+                                       GLenum format,
+                                       GLsizei size,
+                                       const void* data) {
+  glCompressedTextureSubImage2D(_id, level, x, y, width, height, format, size, data);
+}
+
 void Texture::copy_sub_image(GLint level,
                              GLint x,
                              GLint y,
@@ -131,33 +306,61 @@ void Texture::copy_sub_image(GLint level,
   glCopyTextureSubImage2D(_id, level, x, y, read_buffer_x, read_buffer_y, width, height);
 }
 
-bool Texture::load_image_from_file(const std::string& filename) {
-  int width, height, num_channels;
-  stbi_set_flip_vertically_on_load(1);
-  unsigned char* data = stbi_load(filename.c_str(), &width, &height, &num_channels, 0);
-
-  if (nullptr == data) {
-    spdlog::error("Failed to load image from file '{}'", filename);
+bool Texture::load_image_from_file(const std::string& filename, bool mipmaps, bool srgb, ThreadPool* pool) {
+  try {
+    if (CompressedImage::is_compressed_file(filename)) {
+      load_compressed_image(CompressedImage::load_from_file(filename));
+    } else if (mipmaps) {
+      load_mip_chain(Image::load_from_file(filename).mip_chain(srgb, pool));
+    } else {
+      load_image(Image::load_from_file(filename));
+    }
+  } catch (const std::runtime_error&) {
     return false;
   }
+  return true;
+}
 
-  GLenum format = GL_RGB;
-  GLenum internal_format = GL_RGB8;
+void Texture::load_image(const Image& image) {
+  // rows of decoded images are tightly packed
+  StateCache::current().set_unpack_alignment(1);
+  this->set_storage(1, image.internal_format(), image.width(), image.height());
+  this->set_sub_image(0, 0, 0, image.width(), image.height(), image.format(), GL_UNSIGNED_BYTE,
+                      image.pixels().data());
+}
 
-  if (num_channels == 4) {
-    format = GL_RGBA;
-    internal_format = GL_RGBA8;
+void Texture::load_mip_chain(const std::vector<Image>& levels) {
+  if (levels.empty()) {
+    return;
   }
+  StateCache::current().set_unpack_alignment(1);
+  const auto& base = levels.front();
+  this->set_storage(levels.size(), base.internal_format(), base.width(), base.height());
+  for (std::size_t i = 0; i < levels.size(); ++i) {
+    this->set_sub_image(i, 0, 0, levels[i].width(), levels[i].height(), levels[i].format(), GL_UNSIGNED_BYTE,
+                        levels[i].pixels().data());
+  }
+  if (levels.size() > 1) {
+    this->set_min_filter(GL_LINEAR_MIPMAP_LINEAR);
+  }
+}
 
-  this->set_storage(1, internal_format, width, height);
-  this->set_sub_image(0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
-  stbi_image_free(data);
-
-  return true;
+void Texture::load_compressed_image(const CompressedImage& image) {
+  if (is_s3tc(image.internal_format()) && !GLAD_GL_EXT_texture_compression_s3tc) {
+    throw std::runtime_error("BC1 and BC3 textures need GL_EXT_texture_compression_s3tc");
+  }
+  this->set_storage(image.levels(), image.internal_format(), image.width(), image.height());
+  for (unsigned int i = 0; i < image.levels(); ++i) {
+    const auto& level = image.level(i);
+    this->set_compressed_sub_image(i, 0, 0, level.width, level.height, image.internal_format(), level.size,
+                                   image.level_data(i));
+  }
+  spdlog::debug("Uploaded {} compressed levels of {} bytes", image.levels(), image.memory_size());
 }
 
 void Texture::destroy() {
-  if (glIsTexture(_id)) {
+  if (_owner && glIsTexture(_id)) {
+    StateCache::current().forget_texture(_id);
     glDeleteTextures(1, &_id);
   }
 }
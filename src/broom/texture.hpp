@@ -1,16 +1,25 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
+#include <broom/compressed_image.hpp>
+#include <broom/image.hpp>
 #include <broom/opengl.hpp>
+#include <broom/state_cache.hpp>
+#include <broom/thread_pool.hpp>
 
 namespace broom {
 
+// bytes per pixel of tightly packed client pixel data, 0 for unknown combinations
+GLsizeiptr pixel_size(GLenum format, GLenum type);
+
+// A copy does not own the texture, only the original deletes it.
 class Texture {
  public:
-  Texture();
+  Texture(GLenum target = GL_TEXTURE_2D);
   Texture(const Texture& other);
   Texture(Texture&& other);
   ~Texture();
@@ -18,18 +27,39 @@ class Texture {
   Texture& operator=(const Texture& other);
   Texture& operator=(Texture&& other);
 
-  static Texture load_from_file(const std::string& filename);
-
+  // mipmaps are built on the CPU with gamma correct filtering unless srgb is false, on the pool's threads if
+  // one is given, compressed files bring their own levels
+  static Texture load_from_file(const std::string& filename,
+                                bool mipmaps = false,
+                                bool srgb = true,
+                                ThreadPool* pool = nullptr);
+  // decodes on the pool's threads and uploads each image on the calling thread as soon as it is ready,
+  // RGB images are expanded to RGBA and DDS or KTX2 files are uploaded as they are, files that fail to load
+  // are logged and leave their texture invalid
+  static std::vector<Texture> load_from_files(const std::vector<std::string>& filenames,
+                                              ThreadPool& pool,
+                                              bool mipmaps = false,
+                                              bool srgb = true);
+
+  bool valid() const;
   GLuint id() const;
+  GLenum target() const;
   GLenum format() const;
   unsigned int width(GLuint level = 0) const;
   unsigned int height(GLuint level = 0) const;
+  // layers of array textures
+  unsigned int depth(GLuint level = 0) const;
   glm::uvec2 size() const;
   bool has_alpha() const;
+  bool compressed() const;
+  // GPU memory of all levels, exact for compressed formats and estimated from the bit depths otherwise
+  std::size_t memory_size() const;
 
   void bind() const;
-  static void unbind();
+  static void unbind(GLenum target = GL_TEXTURE_2D);
   void bind_unit(GLuint unit) const;
+  // binds a level for image load/store, e.g. from compute shaders, a negative layer binds all layers
+  void bind_image(GLuint unit, GLenum access, GLenum format, GLint level = 0, GLint layer = -1) const;
   static void set_active(GLenum unit);
   void generate_mipmap();
 
@@ -41,14 +71,34 @@ class Texture {
   void set_mag_filter(GLenum mode);
 
   void set_storage(GLsizei levels, GLenum internal_format, GLsizei width, GLsizei height);
+  // for array textures depth is the number of layers
+  void set_storage(GLsizei levels, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth);
+  void set_sub_image(GLint level,
+                     GLint x,
+                     GLint y,
+                     GLsizei width,
+                     GLsizei height,
+                     GLenum format,
+                     GLenum type,
+                     const void* data);
   void set_sub_image(GLint level,
                      GLint x,
                      GLint y,
+                     GLint z,
                      GLsizei width,
                      GLsizei height,
+                     GLsizei depth,
                      GLenum format,
                      GLenum type,
                      const void* data);
+  void set_compressed_sub_image(GLint level,
+                                GLint x,
+                                GLint y,
+                                GLsizei width,
+                                GLsizei height,
+                                GLenum format,
+                                GLsizei size,
+                                const void* data);
   void copy_sub_image(GLint level,
                       GLint x,
                       GLint y,
@@ -57,7 +107,16 @@ class Texture {
                       GLsizei width,
                       GLsizei height);
 
-  bool load_image_from_file(const std::string& filename);
+  bool load_image_from_file(const std::string& filename,
+                            bool mipmaps = false,
+                            bool srgb = true,
+                            ThreadPool* pool = nullptr);
+  // allocates a single level of storage matching the image and uploads it
+  void load_image(const Image& image);
+  // allocates one level per image, as built by Image::mip_chain, and uploads them all
+  void load_mip_chain(const std::vector<Image>& levels);
+  // allocates and uploads all levels stored in the image, throws if the context lacks S3TC for BC1 and BC3
+  void load_compressed_image(const CompressedImage& image);
 
  protected:
   void destroy();
@@ -67,7 +126,8 @@ class Texture {
   GLfloat get_float_level_paremeter(GLenum parameter, GLuint level = 0) const;
 
  protected:
- bool _owner;
+  bool _owner;
+  GLenum _target;
   GLuint _id;
 };
 
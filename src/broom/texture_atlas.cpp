@@ -0,0 +1,204 @@
+#include <broom/texture_atlas.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace broom {
+
+SkylinePacker::SkylinePacker(unsigned int width, unsigned int height) : _width{width}, _height{height}, _used{0} {
+  clear();
+}
+
+unsigned int SkylinePacker::width() const {
+  return _width;
+}
+
+unsigned int SkylinePacker::height() const {
+  return _height;
+}
+
+float SkylinePacker::occupancy() const {
+  return static_cast<float>(_used) / (static_cast<std::uint64_t>(_width) * _height);
+}
+
+bool SkylinePacker::pack(unsigned int width, unsigned int height, glm::uvec2& position) {
+  // bottom-left rule, the placement whose top edge ends up lowest wins
+  std::size_t best = _skyline.size();
+  unsigned int best_top = _height + 1;
+  unsigned int best_y = 0;
+  for (std::size_t i = 0; i < _skyline.size(); ++i) {
+    unsigned int y;
+    if (fit(i, width, height, y) && y + height < best_top) {
+      best = i;
+      best_top = y + height;
+      best_y = y;
+    }
+  }
+  if (best == _skyline.size()) {
+    return false;
+  }
+
+  Segment placed{_skyline[best].x, best_y + height, width};
+  _skyline.insert(_skyline.begin() + best, placed);
+
+  // the new segment hides the parts of the following ones that it covers
+  auto end = placed.x + placed.width;
+  for (auto i = best + 1; i < _skyline.size();) {
+    auto& segment = _skyline[i];
+    if (segment.x >= end) {
+      break;
+    }
+    if (segment.x + segment.width <= end) {
+      _skyline.erase(_skyline.begin() + i);
+      continue;
+    }
+    segment.width -= end - segment.x;
+    segment.x = end;
+    break;
+  }
+
+  for (std::size_t i = 0; i + 1 < _skyline.size();) {
+    if (_skyline[i].y == _skyline[i + 1].y) {
+      _skyline[i].width += _skyline[i + 1].width;
+      _skyline.erase(_skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+
+  _used += static_cast<std::uint64_t>(width) * height;
+  position = glm::uvec2{placed.x, best_y};
+  return true;
+}
+
+void SkylinePacker::clear() {
+  _skyline.assign(1, Segment{0, 0, _width});
+  _used = 0;
+}
+
+bool SkylinePacker::fit(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const {
+  if (_skyline[index].x + width > _width) {
+    return false;
+  }
+  y = 0;
+  unsigned int remaining = width;
+  for (auto i = index; remaining > 0; ++i) {
+    y = std::max(y, _skyline[i].y);
+    if (y + height > _height) {
+      return false;
+    }
+    remaining -= std::min(remaining, _skyline[i].width);
+  }
+  return true;
+}
+
+TextureAtlas::TextureAtlas(unsigned int layer_width, unsigned int layer_height, unsigned int padding)
+    : _layer_width{layer_width},
+      _layer_height{layer_height},
+      _padding{padding},
+      _layers{0},
+      _texture{GL_TEXTURE_2D_ARRAY} {}
+
+std::size_t TextureAtlas::add(Image image) {
+  if (image.channels() != 3 && image.channels() != 4) {
+    throw std::runtime_error("Texture atlases only hold RGB and RGBA images");
+  }
+  image.expand_to_rgba();
+  _images.push_back(std::move(image));
+  return _images.size() - 1;
+}
+
+void TextureAtlas::build() {
+  std::vector<std::size_t> order(_images.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+    return _images[a].height() > _images[b].height() ||
+           (_images[a].height() == _images[b].height() && _images[a].width() > _images[b].width());
+  });
+
+  std::vector<SkylinePacker> packers;
+  _regions.assign(_images.size(), AtlasRegion{});
+  for (auto index : order) {
+    const auto& image = _images[index];
+    auto width = image.width() + 2 * _padding;
+    auto height = image.height() + 2 * _padding;
+
+    glm::uvec2 position;
+    unsigned int layer = 0;
+    while (layer < packers.size() && !packers[layer].pack(width, height, position)) {
+      ++layer;
+    }
+    if (layer == packers.size()) {
+      packers.emplace_back(_layer_width, _layer_height);
+      if (!packers.back().pack(width, height, position)) {
+        spdlog::error("Image of {}x{} does not fit into atlas layers of {}x{}", image.width(), image.height(),
+                      _layer_width, _layer_height);
+        throw std::runtime_error("Image too large for texture atlas!");
+      }
+    }
+
+    glm::uvec2 origin = position + glm::uvec2{_padding, _padding};
+    glm::vec2 layer_size{_layer_width, _layer_height};
+    _regions[index] = AtlasRegion{glm::vec2{origin} / layer_size,
+                                  glm::vec2{origin + glm::uvec2{image.width(), image.height()}} / layer_size, layer,
+                                  origin, glm::uvec2{image.width(), image.height()}};
+  }
+  _layers = std::max(1u, static_cast<unsigned int>(packers.size()));
+
+  // storage is immutable, a rebuild needs a fresh texture
+  _texture = Texture{GL_TEXTURE_2D_ARRAY};
+  _texture.set_storage(1, GL_RGBA8, _layer_width, _layer_height, _layers);
+  _texture.set_min_filter(GL_LINEAR);
+  _texture.set_mag_filter(GL_LINEAR);
+  _texture.set_wrap_s(GL_CLAMP_TO_EDGE);
+  _texture.set_wrap_t(GL_CLAMP_TO_EDGE);
+
+  StateCache::current().set_unpack_alignment(1);
+  std::vector<std::uint8_t> pixels(std::size_t{_layer_width} * _layer_height * 4);
+  for (unsigned int layer = 0; layer < _layers; ++layer) {
+    std::fill(pixels.begin(), pixels.end(), 0);
+    for (std::size_t i = 0; i < _images.size(); ++i) {
+      if (_regions[i].layer == layer) {
+        blit(pixels, _images[i], _regions[i].position - glm::uvec2{_padding, _padding});
+      }
+    }
+    _texture.set_sub_image(0, 0, 0, layer, _layer_width, _layer_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  }
+
+  spdlog::debug("Packed {} images into {} atlas layers of {}x{}", _images.size(), _layers, _layer_width,
+                _layer_height);
+}
+
+const Texture& TextureAtlas::texture() const {
+  return _texture;
+}
+
+unsigned int TextureAtlas::layers() const {
+  return _layers;
+}
+
+const std::vector<AtlasRegion>& TextureAtlas::regions() const {
+  return _regions;
+}
+
+const AtlasRegion& TextureAtlas::region(std::size_t index) const {
+  return _regions.at(index);
+}
+
+void TextureAtlas::blit(std::vector<std::uint8_t>& layer, const Image& image, const glm::uvec2& position) const {
+  // copies the image into the padded rectangle at position, clamping to repeat its edges into the padding
+  int padding = _padding;
+  int width = image.width();
+  int height = image.height();
+  for (int y = -padding; y < height + padding; ++y) {
+    int source_y = std::min(std::max(y, 0), height - 1);
+    auto destination = &layer[((position.y + padding + y) * std::size_t{_layer_width} + position.x) * 4];
+    for (int x = -padding; x < width + padding; ++x) {
+      int source_x = std::min(std::max(x, 0), width - 1);
+      std::copy_n(&image.pixels()[(std::size_t(source_y) * width + source_x) * 4], 4,
+                  destination + (padding + x) * 4);
+    }
+  }
+}
+
+}  // namespace broom
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/image.hpp>
+#include <broom/opengl.hpp>
+#include <broom/texture.hpp>
+
+namespace broom {
+
+// Packs rectangles into a fixed area bottom-left first, tracking only the upper outline of what is placed.
+class SkylinePacker {
+ public:
+  SkylinePacker(unsigned int width, unsigned int height);
+
+  unsigned int width() const;
+  unsigned int height() const;
+  // fraction of the area covered by packed rectangles
+  float occupancy() const;
+
+  // returns false and leaves the packer unchanged if the rectangle does not fit
+  bool pack(unsigned int width, unsigned int height, glm::uvec2& position);
+  void clear();
+
+ protected:
+  struct Segment {
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+  };
+
+  // lowest y at which a rectangle of the given width fits when starting at segment index
+  bool fit(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const;
+
+ protected:
+  unsigned int _width;
+  unsigned int _height;
+  std::uint64_t _used;
+  std::vector<Segment> _skyline;
+};
+
+// Where an image ended up in the atlas, uv coordinates exclude the padding around it.
+struct AtlasRegion {
+  glm::vec2 uv_min;
+  glm::vec2 uv_max;
+  unsigned int layer;
+  glm::uvec2 position;
+  glm::uvec2 size;
+};
+
+// Collects many small images and packs them into the layers of one RGBA8 GL_TEXTURE_2D_ARRAY, so that
+// everything drawn from it shares a single texture binding. Shaders sample it with the region's layer:
+//
+//   uniform sampler2DArray atlas;
+//   ... texture(atlas, vec3(uv, layer)) ...
+//
+// Edge pixels are repeated into the padding so that linear filtering does not bleed between images.
+class TextureAtlas {
+ public:
+  TextureAtlas(unsigned int layer_width, unsigned int layer_height, unsigned int padding = 1);
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas(TextureAtlas&&) = delete;
+
+  TextureAtlas& operator=(const TextureAtlas& other) = delete;
+  TextureAtlas& operator=(TextureAtlas&& other) = delete;
+
+  // RGB and RGBA images only, returns the index of the image's region
+  std::size_t add(Image image);
+  // packs the images tallest first, into as many layers as needed, and uploads them
+  void build();
+
+  const Texture& texture() const;
+  unsigned int layers() const;
+  const std::vector<AtlasRegion>& regions() const;
+  const AtlasRegion& region(std::size_t index) const;
+
+ protected:
+  void blit(std::vector<std::uint8_t>& layer, const Image& image, const glm::uvec2& position) const;
+
+ protected:
+  unsigned int _layer_width;
+  unsigned int _layer_height;
+  unsigned int _padding;
+  std::vector<Image> _images;
+  std::vector<AtlasRegion> _regions;
+  unsigned int _layers;
+  Texture _texture;
+};
+
+}  // namespace broom
@@ -0,0 +1,134 @@
+#include <broom/texture_upload_queue.hpp>
+
+namespace broom {
+
+namespace {
+
+// offsets into the unpack buffer have to be multiples of the pixel type's size
+constexpr GLsizeiptr staging_alignment = 16;
+
+}  // namespace
+
+TextureUpload::TextureUpload() {}
+
+bool TextureUpload::valid() const {
+  return _ready != nullptr;
+}
+
+bool TextureUpload::ready() const {
+  return _ready && *_ready;
+}
+
+TextureUploadQueue::TextureUploadQueue(GLsizeiptr staging_size, unsigned int staging_regions)
+    : _staging{staging_size, staging_regions}, _in_flight(staging_regions), _pending{0} {}
+
+std::size_t TextureUploadQueue::pending() const {
+  return _pending;
+}
+
+GLsizeiptr TextureUploadQueue::queued_bytes() const {
+  GLsizeiptr bytes = 0;
+  for (const auto& job : _queued) {
+    bytes += (job.height - job.staged_rows) * job.row_size;
+  }
+  return bytes;
+}
+
+TextureUpload TextureUploadQueue::upload(const Texture& texture,
+                                         GLint level,
+                                         GLint x,
+                                         GLint y,
+                                         GLsizei width,
+                                         GLsizei height,
+                                         GLenum format,
+                                         GLenum type,
+                                         const void* data) {
+  auto row_size = width * pixel_size(format, type);
+  if (row_size == 0) {
+    throw std::runtime_error("Unsupported pixel format for texture upload");
+  }
+  if (row_size + staging_alignment > _staging.region_size()) {
+    spdlog::error("A row of {} bytes does not fit into the staging region of {} bytes", row_size,
+                  _staging.region_size());
+    throw std::runtime_error("Texture upload exceeds the staging memory!");
+  }
+
+  TextureUpload upload;
+  upload._ready = std::make_shared<bool>(false);
+  ++_pending;
+
+  Job job{texture, level, x, y, width, height, format, type, row_size, 0, 0, {}, upload._ready};
+  auto pixels = static_cast<const std::uint8_t*>(data);
+  // keep the order of uploads, later ones must not overtake queued rows of the same texture
+  if (_queued.empty() && stage(job, pixels)) {
+    return upload;
+  }
+
+  job.queued_row = job.staged_rows;
+  job.pixels.assign(pixels + job.queued_row * row_size, pixels + height * row_size);
+  _queued.push_back(std::move(job));
+  return upload;
+}
+
+TextureUpload TextureUploadQueue::load_image_from_file(Texture& texture, const std::string& filename) {
+  return upload_image(texture, Image::load_from_file(filename));
+}
+
+TextureUpload TextureUploadQueue::upload_image(Texture& texture, const Image& image) {
+  texture.set_storage(1, image.internal_format(), image.width(), image.height());
+  return upload(texture, 0, 0, 0, image.width(), image.height(), image.format(), GL_UNSIGNED_BYTE,
+                image.pixels().data());
+}
+
+void TextureUploadQueue::next_frame() {
+  _staging.next_frame();
+
+  // the GPU is done with the region we are about to reuse
+  auto& done = _in_flight[_staging.current_region()];
+  for (auto& ready : done) {
+    *ready = true;
+  }
+  _pending -= done.size();
+  done.clear();
+
+  stage_queued();
+}
+
+bool TextureUploadQueue::stage(Job& job, const std::uint8_t* rows) {
+  auto fitting = (_staging.available() - staging_alignment + 1) / job.row_size;
+  auto count = static_cast<GLsizei>(std::min<GLsizeiptr>(fitting, job.height - job.staged_rows));
+  if (count <= 0) {
+    return false;
+  }
+
+  auto allocation = _staging.allocate(count * job.row_size, staging_alignment);
+  std::memcpy(allocation.data, rows, count * job.row_size);
+
+  auto& cache = StateCache::current();
+  cache.bind_buffer(GL_PIXEL_UNPACK_BUFFER, _staging.buffer().id());
+  cache.set_unpack_alignment(1);
+  // with an unpack buffer bound the data pointer is an offset into it
+  job.texture.set_sub_image(job.level, job.x, job.y + job.staged_rows, job.width, count, job.format, job.type,
+                            reinterpret_cast<const void*>(allocation.offset));
+  // later uploads from client memory must not read from the staging buffer
+  cache.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  job.staged_rows += count;
+  if (job.staged_rows < job.height) {
+    return false;
+  }
+  _in_flight[_staging.current_region()].push_back(job.ready);
+  return true;
+}
+
+void TextureUploadQueue::stage_queued() {
+  while (!_queued.empty()) {
+    auto& job = _queued.front();
+    if (!stage(job, job.pixels.data() + (job.staged_rows - job.queued_row) * job.row_size)) {
+      return;
+    }
+    _queued.pop_front();
+  }
+}
+
+}  // namespace broom
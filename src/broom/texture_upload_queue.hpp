@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/image.hpp>
+#include <broom/opengl.hpp>
+#include <broom/state_cache.hpp>
+#include <broom/stream_buffer.hpp>
+#include <broom/texture.hpp>
+
+namespace broom {
+
+// Completion flag of a queued upload, ready once the GPU has copied all of its pixels into the texture.
+class TextureUpload {
+ public:
+  TextureUpload();
+
+  bool valid() const;
+  bool ready() const;
+
+ protected:
+  friend class TextureUploadQueue;
+  std::shared_ptr<bool> _ready;
+};
+
+// Uploads texture images through persistently mapped pixel unpack buffers instead of client memory.
+//
+// Each frame may stage up to staging_size bytes, the GPU copies them into the textures asynchronously.
+// Larger images are split into rows and continue over the next frames, staging memory is reused once
+// its fence signals, which is also when the uploads that used it become ready.
+class TextureUploadQueue {
+ public:
+  TextureUploadQueue(GLsizeiptr staging_size = 8 * 1024 * 1024, unsigned int staging_regions = 3);
+  TextureUploadQueue(const TextureUploadQueue&) = delete;
+  TextureUploadQueue(TextureUploadQueue&&) = delete;
+
+  TextureUploadQueue& operator=(const TextureUploadQueue& other) = delete;
+  TextureUploadQueue& operator=(TextureUploadQueue&& other) = delete;
+
+  // uploads not yet ready
+  std::size_t pending() const;
+  // bytes waiting for staging memory in later frames
+  GLsizeiptr queued_bytes() const;
+
+  // the texture needs storage and must outlive the upload, the pixels are copied before returning
+  TextureUpload upload(const Texture& texture,
+                       GLint level,
+                       GLint x,
+                       GLint y,
+                       GLsizei width,
+                       GLsizei height,
+                       GLenum format,
+                       GLenum type,
+                       const void* data);
+  // decodes the image, allocates storage for it and queues the upload of its pixels
+  TextureUpload load_image_from_file(Texture& texture, const std::string& filename);
+  // e.g. for images decoded on a ThreadPool
+  TextureUpload upload_image(Texture& texture, const Image& image);
+
+  // call once per frame after the draws, retires staging memory and continues queued uploads
+  void next_frame();
+
+ protected:
+  struct Job {
+    Texture texture;
+    GLint level;
+    GLint x;
+    GLint y;
+    GLsizei width;
+    GLsizei height;
+    GLenum format;
+    GLenum type;
+    GLsizeiptr row_size;
+    GLsizei staged_rows;
+    // copy of the rows from queued_row on that did not fit when the upload was issued
+    GLsizei queued_row;
+    std::vector<std::uint8_t> pixels;
+    std::shared_ptr<bool> ready;
+  };
+
+  // stages as many of the rows from staged_rows on as fit into the current region, returns whether all are
+  bool stage(Job& job, const std::uint8_t* rows);
+  void stage_queued();
+
+ protected:
+  StreamBuffer _staging;
+  std::deque<Job> _queued;
+  std::vector<std::vector<std::shared_ptr<bool>>> _in_flight;
+  std::size_t _pending;
+};
+
+}  // namespace broom
@@ -0,0 +1,70 @@
+#include <broom/thread_pool.hpp>
+
+namespace broom {
+
+ThreadPool::ThreadPool(unsigned int threads) : _stopping{false} {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  _threads.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    _threads.emplace_back([this]() { work(); });
+  }
+  spdlog::debug("Started thread pool with {} threads", threads);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _stopping = true;
+  }
+  _condition.notify_all();
+  // queued tasks still run so that no future is left without a result
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+std::size_t ThreadPool::size() const {
+  return _threads.size();
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _tasks.push_back(std::move(task));
+  }
+  _condition.notify_one();
+}
+
+bool ThreadPool::run_one() {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (_tasks.empty()) {
+      return false;
+    }
+    task = std::move(_tasks.front());
+    _tasks.pop_front();
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock{_mutex};
+      _condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+      if (_tasks.empty()) {
+        return;
+      }
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace broom
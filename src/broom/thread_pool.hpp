@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace broom {
+
+// A fixed set of worker threads running submitted tasks in order of submission.
+// Tasks must not touch GL, the context is only current on the thread that created it.
+class ThreadPool {
+ public:
+  // defaults to one thread per hardware thread
+  ThreadPool(unsigned int threads = 0);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ~ThreadPool();
+
+  ThreadPool& operator=(const ThreadPool& other) = delete;
+  ThreadPool& operator=(ThreadPool&& other) = delete;
+
+  std::size_t size() const;
+
+  // exceptions thrown by the task are rethrown from the future's get()
+  template <typename F>
+  auto submit(F&& function) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+    auto future = task->get_future();
+    enqueue([task]() { (*task)(); });
+    return future;
+  }
+
+  // runs queued tasks on the calling thread until the future is ready, so that a task can wait for the
+  // tasks it submitted to the same pool without every worker ending up blocked
+  template <typename T>
+  T wait(std::future<T>& future) {
+    while (future.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+      if (!run_one()) {
+        future.wait();
+      }
+    }
+    return future.get();
+  }
+
+ protected:
+  void enqueue(std::function<void()> task);
+  // false if there was no task to run
+  bool run_one();
+  void work();
+
+ protected:
+  std::vector<std::thread> _threads;
+  std::deque<std::function<void()>> _tasks;
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _stopping;
+};
+
+}  // namespace broom
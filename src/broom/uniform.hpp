@@ -0,0 +1,165 @@
+#pragma once
+
+#include <type_traits>
+
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// Maps a value type to its glProgramUniform call at compile time, count is the number of values, not
+// components. Specialized for the GL scalar types and glm's vectors and matrices.
+template <typename T>
+struct Uniform;
+
+template <glm::length_t L>
+void program_uniform(GLuint program, GLint location, GLsizei count, const GLint* values) {
+  if constexpr (L == 1) {
+    glProgramUniform1iv(program, location, count, values);
+  } else if constexpr (L == 2) {
+    glProgramUniform2iv(program, location, count, values);
+  } else if constexpr (L == 3) {
+    glProgramUniform3iv(program, location, count, values);
+  } else {
+    glProgramUniform4iv(program, location, count, values);
+  }
+}
+
+template <glm::length_t L>
+void program_uniform(GLuint program, GLint location, GLsizei count, const GLuint* values) {
+  if constexpr (L == 1) {
+    glProgramUniform1uiv(program, location, count, values);
+  } else if constexpr (L == 2) {
+    glProgramUniform2uiv(program, location, count, values);
+  } else if constexpr (L == 3) {
+    glProgramUniform3uiv(program, location, count, values);
+  } else {
+    glProgramUniform4uiv(program, location, count, values);
+  }
+}
+
+template <glm::length_t L>
+void program_uniform(GLuint program, GLint location, GLsizei count, const GLfloat* values) {
+  if constexpr (L == 1) {
+    glProgramUniform1fv(program, location, count, values);
+  } else if constexpr (L == 2) {
+    glProgramUniform2fv(program, location, count, values);
+  } else if constexpr (L == 3) {
+    glProgramUniform3fv(program, location, count, values);
+  } else {
+    glProgramUniform4fv(program, location, count, values);
+  }
+}
+
+template <glm::length_t L>
+void program_uniform(GLuint program, GLint location, GLsizei count, const GLdouble* values) {
+  if constexpr (L == 1) {
+    glProgramUniform1dv(program, location, count, values);
+  } else if constexpr (L == 2) {
+    glProgramUniform2dv(program, location, count, values);
+  } else if constexpr (L == 3) {
+    glProgramUniform3dv(program, location, count, values);
+  } else {
+    glProgramUniform4dv(program, location, count, values);
+  }
+}
+
+// C columns of R rows each, as in glm and GLSL
+template <glm::length_t C, glm::length_t R>
+void program_uniform_matrix(GLuint program, GLint location, GLsizei count, const GLfloat* values) {
+  if constexpr (C == 2 && R == 2) {
+    glProgramUniformMatrix2fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 3 && R == 3) {
+    glProgramUniformMatrix3fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 4 && R == 4) {
+    glProgramUniformMatrix4fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 2 && R == 3) {
+    glProgramUniformMatrix2x3fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 3 && R == 2) {
+    glProgramUniformMatrix3x2fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 2 && R == 4) {
+    glProgramUniformMatrix2x4fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 4 && R == 2) {
+    glProgramUniformMatrix4x2fv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 3 && R == 4) {
+    glProgramUniformMatrix3x4fv(program, location, count, GL_FALSE, values);
+  } else {
+    glProgramUniformMatrix4x3fv(program, location, count, GL_FALSE, values);
+  }
+}
+
+template <glm::length_t C, glm::length_t R>
+void program_uniform_matrix(GLuint program, GLint location, GLsizei count, const GLdouble* values) {
+  if constexpr (C == 2 && R == 2) {
+    glProgramUniformMatrix2dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 3 && R == 3) {
+    glProgramUniformMatrix3dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 4 && R == 4) {
+    glProgramUniformMatrix4dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 2 && R == 3) {
+    glProgramUniformMatrix2x3dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 3 && R == 2) {
+    glProgramUniformMatrix3x2dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 2 && R == 4) {
+    glProgramUniformMatrix2x4dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 4 && R == 2) {
+    glProgramUniformMatrix4x2dv(program, location, count, GL_FALSE, values);
+  } else if constexpr (C == 3 && R == 4) {
+    glProgramUniformMatrix3x4dv(program, location, count, GL_FALSE, values);
+  } else {
+    glProgramUniformMatrix4x3dv(program, location, count, GL_FALSE, values);
+  }
+}
+
+template <typename T>
+constexpr bool is_uniform_component =
+    std::is_same_v<T, GLint> || std::is_same_v<T, GLuint> || std::is_same_v<T, GLfloat> || std::is_same_v<T, GLdouble>;
+
+template <>
+struct Uniform<GLint> {
+  static void set(GLuint program, GLint location, GLsizei count, const GLint* values) {
+    program_uniform<1>(program, location, count, values);
+  }
+};
+
+template <>
+struct Uniform<GLuint> {
+  static void set(GLuint program, GLint location, GLsizei count, const GLuint* values) {
+    program_uniform<1>(program, location, count, values);
+  }
+};
+
+template <>
+struct Uniform<GLfloat> {
+  static void set(GLuint program, GLint location, GLsizei count, const GLfloat* values) {
+    program_uniform<1>(program, location, count, values);
+  }
+};
+
+template <>
+struct Uniform<GLdouble> {
+  static void set(GLuint program, GLint location, GLsizei count, const GLdouble* values) {
+    program_uniform<1>(program, location, count, values);
+  }
+};
+
+template <glm::length_t L, typename T, glm::qualifier Q>
+struct Uniform<glm::vec<L, T, Q>> {
+  static_assert(is_uniform_component<T>, "Uniform vectors hold GLint, GLuint, GLfloat or GLdouble");
+  static_assert(sizeof(glm::vec<L, T, Q>) == L * sizeof(T), "Aligned glm types are not tightly packed");
+
+  static void set(GLuint program, GLint location, GLsizei count, const glm::vec<L, T, Q>* values) {
+    program_uniform<L>(program, location, count, reinterpret_cast<const T*>(values));
+  }
+};
+
+template <glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+struct Uniform<glm::mat<C, R, T, Q>> {
+  static_assert(std::is_same_v<T, GLfloat> || std::is_same_v<T, GLdouble>, "Uniform matrices hold floats or doubles");
+  static_assert(sizeof(glm::mat<C, R, T, Q>) == C * R * sizeof(T), "Aligned glm types are not tightly packed");
+
+  static void set(GLuint program, GLint location, GLsizei count, const glm::mat<C, R, T, Q>* values) {
+    program_uniform_matrix<C, R>(program, location, count, reinterpret_cast<const T*>(values));
+  }
+};
+
+}  // namespace broom
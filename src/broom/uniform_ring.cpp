@@ -0,0 +1,49 @@
+#include <broom/uniform_ring.hpp>
+
+namespace broom {
+
+UniformRing::UniformRing(GLsizeiptr region_size, unsigned int regions, GLenum target)
+    : _target{target}, _offset_alignment{query_offset_alignment(target)}, _stream{region_size, regions} {
+  spdlog::debug("Created uniform ring {} with ranges aligned to {} bytes", _stream.buffer().id(), _offset_alignment);
+}
+
+const Buffer& UniformRing::buffer() const {
+  return _stream.buffer();
+}
+
+GLenum UniformRing::target() const {
+  return _target;
+}
+
+GLsizeiptr UniformRing::offset_alignment() const {
+  return _offset_alignment;
+}
+
+GLsizeiptr UniformRing::available() const {
+  return _stream.available();
+}
+
+void UniformRing::bind(GLuint binding, const StreamAllocation& allocation) const {
+  StateCache::current().bind_buffer_range(_target, binding, _stream.buffer().id(), allocation.offset,
+                                          allocation.size);
+}
+
+void UniformRing::next_frame() {
+  _stream.next_frame();
+}
+
+GLsizeiptr UniformRing::query_offset_alignment(GLenum target) {
+  GLenum parameter;
+  if (target == GL_UNIFORM_BUFFER) {
+    parameter = GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT;
+  } else if (target == GL_SHADER_STORAGE_BUFFER) {
+    parameter = GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT;
+  } else {
+    throw std::runtime_error("Uniform rings bind to GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER");
+  }
+  GLint alignment = 0;
+  glGetIntegerv(parameter, &alignment);
+  return alignment > 0 ? alignment : 256;
+}
+
+}  // namespace broom
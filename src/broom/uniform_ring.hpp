@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/opengl.hpp>
+#include <broom/state_cache.hpp>
+#include <broom/stream_buffer.hpp>
+
+namespace broom {
+
+// Suballocates per-frame and per-object block data from a StreamBuffer, each write is a range of the same
+// buffer aligned for binding, so switching the data of a draw is a single glBindBufferRange.
+//
+// The target is GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER and picks the offset alignment the driver
+// requires. Data written in a frame stays valid until the ring wraps around to its region again.
+class UniformRing {
+ public:
+  UniformRing(GLsizeiptr region_size, unsigned int regions = 3, GLenum target = GL_UNIFORM_BUFFER);
+  UniformRing(const UniformRing&) = delete;
+  UniformRing(UniformRing&&) = delete;
+
+  UniformRing& operator=(const UniformRing& other) = delete;
+  UniformRing& operator=(UniformRing&& other) = delete;
+
+  const Buffer& buffer() const;
+  GLenum target() const;
+  GLsizeiptr offset_alignment() const;
+  // bytes still free in the current frame
+  GLsizeiptr available() const;
+
+  // copies the value, e.g. a struct checked with Std140Layout, and returns its range for binding
+  template <typename T>
+  StreamAllocation write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Block data is copied byte by byte");
+    auto allocation = _stream.allocate(sizeof(T), _offset_alignment);
+    std::memcpy(allocation.data, &value, sizeof(T));
+    return allocation;
+  }
+  void bind(GLuint binding, const StreamAllocation& allocation) const;
+  // writes the value and binds it in one go
+  template <typename T>
+  StreamAllocation push(GLuint binding, const T& value) {
+    auto allocation = write(value);
+    bind(binding, allocation);
+    return allocation;
+  }
+
+  // call once per frame after the draws that use the written data
+  void next_frame();
+
+ protected:
+  static GLsizeiptr query_offset_alignment(GLenum target);
+
+ protected:
+  GLenum _target;
+  GLsizeiptr _offset_alignment;
+  StreamBuffer _stream;
+};
+
+}  // namespace broom
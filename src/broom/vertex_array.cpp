@@ -23,11 +23,11 @@ GLuint VertexArray::id() const {
 }
 
 void VertexArray::bind() const {
-  glBindVertexArray(_id);
+  StateCache::current().bind_vertex_array(_id);
 }
 
 void VertexArray::unbind() {
-  glBindVertexArray(0);
+  StateCache::current().bind_vertex_array(0);
 }
 
 void VertexArray::set_element_buffer(const Buffer& buffer) {
@@ -38,6 +38,32 @@ void VertexArray::set_vertex_buffer(GLuint binding_index, const Buffer& buffer,
   glVertexArrayVertexBuffer(_id, binding_index, buffer.id(), offset, stride);
 }
 
+void VertexArray::set_vertex_buffer(GLuint binding_index,
+                                    const Buffer& buffer,
+                                    const VertexFormat& format,
+                                    GLintptr offset,
+                                    GLuint divisor) {
+  set_vertex_buffer(binding_index, buffer, offset, format.stride);
+  set_binding_divisor(binding_index, divisor);
+  for (const auto& attribute : format.attributes) {
+    if (attribute.format == AttributeFormat::native && attribute.type == GL_DOUBLE) {
+      set_attribute_format_long(attribute.location, attribute.components, attribute.type, attribute.offset);
+    } else if (attribute.format == AttributeFormat::native && attribute.type != GL_FLOAT &&
+               attribute.type != GL_HALF_FLOAT) {
+      set_attribute_format_integer(attribute.location, attribute.components, attribute.type, attribute.offset);
+    } else {
+      set_attribute_format(attribute.location, attribute.components, attribute.type,
+                           attribute.format == AttributeFormat::normalized, attribute.offset);
+    }
+    set_attribute_binding(attribute.location, binding_index);
+    set_attribute_enabled(attribute.location, true);
+  }
+}
+
+void VertexArray::set_binding_divisor(GLuint binding_index, GLuint divisor) {
+  glVertexArrayBindingDivisor(_id, binding_index, divisor);
+}
+
 void VertexArray::set_attribute_enabled(GLuint index, bool enabled) {
   if (enabled) {
     glEnableVertexArrayAttrib(_id, index);
@@ -76,6 +102,7 @@ GLint VertexArray::get_attribute_parameter(GLuint index, GLenum parameter) const
 
 void VertexArray::destroy() const {
   if (valid()) {
+    StateCache::current().forget_vertex_array(_id);
     glDeleteVertexArrays(1, &_id);
   }
 }
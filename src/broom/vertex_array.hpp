@@ -6,6 +6,8 @@
 
 #include <broom/opengl.hpp>
 #include <broom/buffer.hpp>
+#include <broom/state_cache.hpp>
+#include <broom/vertex_layout.hpp>
 
 namespace broom {
 
@@ -29,6 +31,14 @@ class VertexArray {
 
   void set_element_buffer(const Buffer& buffer);
   void set_vertex_buffer(GLuint binding_index, const Buffer& buffer, GLintptr offset = 0, GLsizei stride = 1);
+  // sets the buffer along with the format, bindings and enabled state of all attributes it feeds
+  void set_vertex_buffer(GLuint binding_index,
+                         const Buffer& buffer,
+                         const VertexFormat& format,
+                         GLintptr offset = 0,
+                         GLuint divisor = 0);
+  // advance the binding once per divisor instances instead of once per vertex, 0 disables instancing
+  void set_binding_divisor(GLuint binding_index, GLuint divisor);
   void set_attribute_enabled(GLuint index, bool enabled = true);
   void set_attribute_binding(GLuint index, GLuint binding_index);
   void set_attribute_format(GLuint index, GLint size, GLenum type, bool normalized = false, GLuint relative_offset = 0);
@@ -0,0 +1,57 @@
+#include <broom/vertex_array_cache.hpp>
+
+#include <algorithm>
+
+namespace broom {
+
+VertexArrayCache::VertexArrayCache() {}
+
+std::size_t VertexArrayCache::size() const {
+  return _entries.size();
+}
+
+const VertexArray& VertexArrayCache::vertex_array(const std::vector<VertexStream>& streams,
+                                                  const Buffer* element_buffer) {
+  std::vector<std::uint64_t> key;
+  key.reserve(1 + 4 * streams.size());
+  key.push_back(element_buffer ? element_buffer->id() : 0);
+  for (const auto& stream : streams) {
+    key.insert(key.end(), {stream.format->hash, stream.buffer->id(), static_cast<std::uint64_t>(stream.offset),
+                           stream.divisor});
+  }
+
+  auto entry = _entries.find(key);
+  if (entry != _entries.end()) {
+    return *entry->second.vertex_array;
+  }
+
+  Entry created{std::make_unique<VertexArray>(), {}};
+  if (element_buffer) {
+    created.vertex_array->set_element_buffer(*element_buffer);
+    created.buffers.push_back(element_buffer->id());
+  }
+  for (GLuint binding = 0; binding < streams.size(); ++binding) {
+    const auto& stream = streams[binding];
+    created.vertex_array->set_vertex_buffer(binding, *stream.buffer, *stream.format, stream.offset, stream.divisor);
+    created.buffers.push_back(stream.buffer->id());
+  }
+  spdlog::debug("Created vertex array {} for {} vertex streams", created.vertex_array->id(), streams.size());
+  return *_entries.emplace(std::move(key), std::move(created)).first->second.vertex_array;
+}
+
+void VertexArrayCache::forget(const Buffer& buffer) {
+  for (auto entry = _entries.begin(); entry != _entries.end();) {
+    const auto& buffers = entry->second.buffers;
+    if (std::find(buffers.begin(), buffers.end(), buffer.id()) != buffers.end()) {
+      entry = _entries.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+void VertexArrayCache::clear() {
+  _entries.clear();
+}
+
+}  // namespace broom
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <broom/buffer.hpp>
+#include <broom/opengl.hpp>
+#include <broom/vertex_array.hpp>
+#include <broom/vertex_layout.hpp>
+
+namespace broom {
+
+// A vertex buffer binding, streams are bound to binding indices in the order they are given.
+struct VertexStream {
+  const VertexFormat* format;
+  const Buffer* buffer;
+  GLintptr offset;
+  GLuint divisor;
+};
+
+// Hands out one vertex array per distinct set of vertex formats, buffers and element buffer.
+//
+// Meshes suballocated from the same buffers, e.g. through a BufferAllocator, share a vertex array and
+// select their vertices with base vertex and first index, so drawing them needs no vertex array switches.
+// Buffers must outlive the vertex arrays that use them, forget() drops those of a buffer about to go.
+class VertexArrayCache {
+ public:
+  VertexArrayCache();
+  VertexArrayCache(const VertexArrayCache&) = delete;
+  VertexArrayCache(VertexArrayCache&&) = delete;
+
+  VertexArrayCache& operator=(const VertexArrayCache& other) = delete;
+  VertexArrayCache& operator=(VertexArrayCache&& other) = delete;
+
+  std::size_t size() const;
+
+  // creates the vertex array on first use
+  const VertexArray& vertex_array(const std::vector<VertexStream>& streams, const Buffer* element_buffer = nullptr);
+  void forget(const Buffer& buffer);
+  void clear();
+
+ protected:
+  struct Entry {
+    std::unique_ptr<VertexArray> vertex_array;
+    std::vector<GLuint> buffers;
+  };
+
+  // the element buffer, then format hash, buffer, offset and divisor of each stream
+  std::map<std::vector<std::uint64_t>, Entry> _entries;
+};
+
+}  // namespace broom
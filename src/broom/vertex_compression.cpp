@@ -0,0 +1,321 @@
+#include <broom/vertex_compression.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BROOM_VERTEX_F16C
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define BROOM_VERTEX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace broom {
+
+namespace {
+
+// the same clamping and round to nearest even as the SSE2 kernels, NaN becomes the lower bound
+float clamp(float value, float low, float high) {
+  return value > low ? (value < high ? value : high) : low;
+}
+
+std::int32_t round_to_int(float value) {
+  return static_cast<std::int32_t>(std::nearbyint(value));
+}
+
+std::uint32_t pack_snorm_2_10_10_10(float x, float y, float z, float w) {
+  auto pack = [](float value, float max, std::uint32_t mask) {
+    return static_cast<std::uint32_t>(round_to_int(clamp(value, -1.0f, 1.0f) * max)) & mask;
+  };
+  return pack(x, 511.0f, 0x3ff) | pack(y, 511.0f, 0x3ff) << 10 | pack(z, 511.0f, 0x3ff) << 20 |
+         pack(w, 1.0f, 0x3) << 30;
+}
+
+std::uint16_t quantize_component(float value, float offset, float inverse_scale) {
+  return static_cast<std::uint16_t>(round_to_int(clamp((value - offset) * inverse_scale, 0.0f, 65535.0f)));
+}
+
+glm::vec3 inverse_scale(const PositionQuantization& quantization) {
+  glm::vec3 result;
+  for (glm::length_t i = 0; i < 3; ++i) {
+    result[i] = quantization.scale[i] > 0.0f ? 65535.0f / quantization.scale[i] : 0.0f;
+  }
+  return result;
+}
+
+#ifdef BROOM_VERTEX_F16C
+__attribute__((target("avx,f16c"))) std::size_t pack_half_f16c(const float* source,
+                                                                std::uint16_t* destination,
+                                                                std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), halves);
+  }
+  return i;
+}
+#endif
+
+#ifdef BROOM_VERTEX_SSE2
+std::size_t pack_unorm8_sse2(const float* source, std::uint8_t* destination, std::size_t count) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 max = _mm_set1_ps(255.0f);
+  // max before min turns NaN into 0 like the scalar clamp
+  auto convert = [&](const float* values) {
+    return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(values), zero), one), max));
+  };
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i low = _mm_packs_epi32(convert(source + i), convert(source + i + 4));
+    __m128i high = _mm_packs_epi32(convert(source + i + 8), convert(source + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(low, high));
+  }
+  return i;
+}
+
+// four normals or tangents per iteration, one component of each per register
+template <glm::length_t L>
+std::size_t pack_normals_sse2(const glm::vec<L, float>* source, PackedNormal* destination, std::size_t count) {
+  const __m128 low = _mm_set1_ps(-1.0f);
+  const __m128 high = _mm_set1_ps(1.0f);
+  const __m128 max = _mm_set1_ps(511.0f);
+  const __m128i mask = _mm_set1_epi32(0x3ff);
+  auto component = [&](__m128 values, __m128 scale, __m128i mask) {
+    return _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(values, low), high), scale)), mask);
+  };
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const auto* v = source + i;
+    __m128 x = _mm_setr_ps(v[0].x, v[1].x, v[2].x, v[3].x);
+    __m128 y = _mm_setr_ps(v[0].y, v[1].y, v[2].y, v[3].y);
+    __m128 z = _mm_setr_ps(v[0].z, v[1].z, v[2].z, v[3].z);
+    __m128i packed = _mm_or_si128(_mm_or_si128(component(x, max, mask), _mm_slli_epi32(component(y, max, mask), 10)),
+                                  _mm_slli_epi32(component(z, max, mask), 20));
+    if constexpr (L == 4) {
+      __m128 w = _mm_setr_ps(v[0].w, v[1].w, v[2].w, v[3].w);
+      packed = _mm_or_si128(packed, _mm_slli_epi32(component(w, high, _mm_set1_epi32(0x3)), 30));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+  }
+  return i;
+}
+
+// four positions are 12 floats in three registers, the components repeat as xyzx, yzxy and zxyz
+std::size_t quantize_positions_sse2(const glm::vec3* source,
+                                    glm::u16vec3* destination,
+                                    std::size_t count,
+                                    const PositionQuantization& quantization) {
+  static_assert(sizeof(glm::vec3) == 12 && sizeof(glm::u16vec3) == 6, "Vectors have to be tightly packed");
+  auto o = quantization.offset;
+  auto s = inverse_scale(quantization);
+  const __m128 offsets[3] = {_mm_setr_ps(o.x, o.y, o.z, o.x), _mm_setr_ps(o.y, o.z, o.x, o.y),
+                             _mm_setr_ps(o.z, o.x, o.y, o.z)};
+  const __m128 scales[3] = {_mm_setr_ps(s.x, s.y, s.z, s.x), _mm_setr_ps(s.y, s.z, s.x, s.y),
+                            _mm_setr_ps(s.z, s.x, s.y, s.z)};
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 max = _mm_set1_ps(65535.0f);
+  // SSE2 only packs to signed 16 bits, so the values are moved into that range and back
+  const __m128i bias = _mm_set1_epi32(32768);
+  const __m128i sign = _mm_set1_epi16(static_cast<short>(0x8000));
+  auto convert = [&](const float* values, int pattern) {
+    __m128 scaled = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values), offsets[pattern]), scales[pattern]);
+    return _mm_sub_epi32(_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(scaled, zero), max)), bias);
+  };
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float* values = &source[i].x;
+    auto* output = reinterpret_cast<std::uint8_t*>(destination + i);
+    __m128i first = _mm_xor_si128(_mm_packs_epi32(convert(values, 0), convert(values + 4, 1)), sign);
+    __m128i last = _mm_xor_si128(_mm_packs_epi32(convert(values + 8, 2), _mm_setzero_si128()), sign);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), first);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(output + 16), last);
+  }
+  return i;
+}
+#endif
+
+}  // namespace
+
+std::uint16_t float_to_half(float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+  std::uint32_t magnitude = bits & 0x7fffffff;
+
+  if (magnitude >= 0x7f800000) {
+    // infinity stays infinity, NaN stays a quiet NaN
+    return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0);
+  }
+  if (magnitude >= 0x477ff000) {
+    // 65520 and above round past the largest half
+    return sign | 0x7c00;
+  }
+  if (magnitude <= 0x33000000) {
+    // half of the smallest subnormal and below round to zero
+    return sign;
+  }
+
+  std::uint32_t result;
+  std::uint32_t remainder;
+  std::uint32_t halfway;
+  if (magnitude < 0x38800000) {
+    // subnormal halves count in steps of 2^-24
+    std::uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+    std::uint32_t shift = 126 - (magnitude >> 23);
+    result = mantissa >> shift;
+    remainder = mantissa & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {
+    // rebias the exponent from 127 to 15 and drop 13 mantissa bits
+    result = (magnitude - 0x38000000) >> 13;
+    remainder = magnitude & 0x1fff;
+    halfway = 0x1000;
+  }
+  // a carry moves into the exponent, which is still the correctly rounded value
+  if (remainder > halfway || (remainder == halfway && (result & 1))) {
+    ++result;
+  }
+  return sign | static_cast<std::uint16_t>(result);
+}
+
+float half_to_float(std::uint16_t bits) {
+  std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000) << 16;
+  std::uint32_t exponent = (bits >> 10) & 0x1f;
+  std::uint32_t mantissa = bits & 0x3ff;
+
+  float magnitude;
+  if (exponent == 0) {
+    magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+  } else if (exponent == 0x1f) {
+    magnitude = mantissa == 0 ? std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+  } else {
+    std::uint32_t result = (exponent + 112) << 23 | mantissa << 13;
+    std::memcpy(&magnitude, &result, sizeof(magnitude));
+  }
+  std::uint32_t result;
+  std::memcpy(&result, &magnitude, sizeof(result));
+  result |= sign;
+  float value;
+  std::memcpy(&value, &result, sizeof(value));
+  return value;
+}
+
+void pack_half(const float* source, std::uint16_t* destination, std::size_t count) {
+  std::size_t i = 0;
+#ifdef BROOM_VERTEX_F16C
+  static const bool f16c = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+  if (f16c) {
+    i = pack_half_f16c(source, destination, count);
+  }
+#endif
+  for (; i < count; ++i) {
+    destination[i] = float_to_half(source[i]);
+  }
+}
+
+std::uint8_t pack_unorm8(float value) {
+  return static_cast<std::uint8_t>(round_to_int(clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+void pack_unorm8(const float* source, std::uint8_t* destination, std::size_t count) {
+  std::size_t i = 0;
+#ifdef BROOM_VERTEX_SSE2
+  i = pack_unorm8_sse2(source, destination, count);
+#endif
+  for (; i < count; ++i) {
+    destination[i] = pack_unorm8(source[i]);
+  }
+}
+
+PackedNormal pack_normal(const glm::vec3& normal) {
+  return PackedNormal{pack_snorm_2_10_10_10(normal.x, normal.y, normal.z, 0.0f)};
+}
+
+PackedNormal pack_normal(const glm::vec4& tangent) {
+  return PackedNormal{pack_snorm_2_10_10_10(tangent.x, tangent.y, tangent.z, tangent.w)};
+}
+
+glm::vec4 unpack_normal(PackedNormal normal) {
+  // sign extends each field by moving it to the top of a signed integer and back
+  auto unpack = [&](int shift, int bits, float max) {
+    auto value = static_cast<std::int32_t>(normal.bits << (32 - shift - bits)) >> (32 - bits);
+    return std::max(value / max, -1.0f);
+  };
+  return glm::vec4{unpack(0, 10, 511.0f), unpack(10, 10, 511.0f), unpack(20, 10, 511.0f), unpack(30, 2, 1.0f)};
+}
+
+void pack_normals(const glm::vec3* source, PackedNormal* destination, std::size_t count) {
+  std::size_t i = 0;
+#ifdef BROOM_VERTEX_SSE2
+  i = pack_normals_sse2(source, destination, count);
+#endif
+  for (; i < count; ++i) {
+    destination[i] = pack_normal(source[i]);
+  }
+}
+
+void pack_normals(const glm::vec4* source, PackedNormal* destination, std::size_t count) {
+  std::size_t i = 0;
+#ifdef BROOM_VERTEX_SSE2
+  i = pack_normals_sse2(source, destination, count);
+#endif
+  for (; i < count; ++i) {
+    destination[i] = pack_normal(source[i]);
+  }
+}
+
+glm::mat4 PositionQuantization::matrix() const {
+  glm::mat4 result{1.0f};
+  result[0][0] = scale.x;
+  result[1][1] = scale.y;
+  result[2][2] = scale.z;
+  result[3] = glm::vec4{offset, 1.0f};
+  return result;
+}
+
+glm::vec3 PositionQuantization::dequantize(const glm::u16vec3& position) const {
+  return offset + scale * (glm::vec3{position} / 65535.0f);
+}
+
+PositionQuantization position_quantization(const glm::vec3* positions, std::size_t count) {
+  if (count == 0) {
+    return PositionQuantization{glm::vec3{0.0f}, glm::vec3{0.0f}};
+  }
+  glm::vec3 low = positions[0];
+  glm::vec3 high = positions[0];
+  for (std::size_t i = 1; i < count; ++i) {
+    low = glm::min(low, positions[i]);
+    high = glm::max(high, positions[i]);
+  }
+  return PositionQuantization{low, high - low};
+}
+
+glm::u16vec3 quantize_position(const glm::vec3& position, const PositionQuantization& quantization) {
+  auto scale = inverse_scale(quantization);
+  glm::u16vec3 result;
+  for (glm::length_t i = 0; i < 3; ++i) {
+    result[i] = quantize_component(position[i], quantization.offset[i], scale[i]);
+  }
+  return result;
+}
+
+void quantize_positions(const glm::vec3* source,
+                        glm::u16vec3* destination,
+                        std::size_t count,
+                        const PositionQuantization& quantization) {
+  std::size_t i = 0;
+#ifdef BROOM_VERTEX_SSE2
+  i = quantize_positions_sse2(source, destination, count, quantization);
+#endif
+  for (; i < count; ++i) {
+    destination[i] = quantize_position(source[i], quantization);
+  }
+}
+
+}  // namespace broom
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/gtc/type_precision.hpp>
+
+#include <broom/opengl.hpp>
+#include <broom/vertex_layout.hpp>
+
+namespace broom {
+
+// L 16 bit floats, read as floats by the shader
+template <glm::length_t L>
+struct PackedHalf {
+  std::array<std::uint16_t, L> bits;
+};
+
+// x, y and z as 10 bit and w as 2 bit signed normalized integers, read as a vec3 or vec4 by the shader
+struct PackedNormal {
+  std::uint32_t bits;
+};
+
+template <glm::length_t L>
+struct VertexAttributeTraits<PackedHalf<L>> : VertexAttributeType<GL_HALF_FLOAT, L> {};
+template <>
+struct VertexAttributeTraits<PackedNormal>
+    : VertexAttributeType<GL_INT_2_10_10_10_REV, 4, AttributeFormat::normalized> {};
+
+// rounds to nearest even, values too large for a half become infinity
+std::uint16_t float_to_half(float value);
+float half_to_float(std::uint16_t bits);
+// count is the number of floats, uses F16C where the CPU has it
+void pack_half(const float* source, std::uint16_t* destination, std::size_t count);
+
+template <glm::length_t L>
+PackedHalf<L> pack_half(const glm::vec<L, float>& value) {
+  PackedHalf<L> result;
+  for (glm::length_t i = 0; i < L; ++i) {
+    result.bits[i] = float_to_half(value[i]);
+  }
+  return result;
+}
+
+// [0, 1] to 8 bit unsigned normalized integers for colors, count is the number of floats
+void pack_unorm8(const float* source, std::uint8_t* destination, std::size_t count);
+std::uint8_t pack_unorm8(float value);
+
+template <glm::length_t L>
+glm::vec<L, std::uint8_t> pack_unorm8(const glm::vec<L, float>& value) {
+  glm::vec<L, std::uint8_t> result;
+  for (glm::length_t i = 0; i < L; ++i) {
+    result[i] = pack_unorm8(value[i]);
+  }
+  return result;
+}
+
+// unit normals get a w of 0, tangents keep the sign of their w as the bitangent's handedness
+PackedNormal pack_normal(const glm::vec3& normal);
+PackedNormal pack_normal(const glm::vec4& tangent);
+glm::vec4 unpack_normal(PackedNormal normal);
+void pack_normals(const glm::vec3* source, PackedNormal* destination, std::size_t count);
+void pack_normals(const glm::vec4* source, PackedNormal* destination, std::size_t count);
+
+// Maps positions inside a bounding box to 16 bit unsigned normalized integers, the shader gets them back
+// with offset + scale * position. matrix() does the same as a transform that can be folded into the model
+// matrix, as it scales non-uniformly normals still have to be transformed with the model matrix alone.
+struct PositionQuantization {
+  glm::vec3 offset;
+  glm::vec3 scale;
+
+  glm::mat4 matrix() const;
+  glm::vec3 dequantize(const glm::u16vec3& position) const;
+};
+
+// the bounding box of the positions, count may be 0
+PositionQuantization position_quantization(const glm::vec3* positions, std::size_t count);
+glm::u16vec3 quantize_position(const glm::vec3& position, const PositionQuantization& quantization);
+void quantize_positions(const glm::vec3* source,
+                        glm::u16vec3* destination,
+                        std::size_t count,
+                        const PositionQuantization& quantization);
+
+}  // namespace broom
@@ -0,0 +1,20 @@
+#include <broom/vertex_layout.hpp>
+
+namespace broom {
+
+VertexFormat::VertexFormat(const std::vector<VertexAttributeFormat>& attributes, GLsizei stride)
+    : attributes{attributes}, stride{stride}, hash{fnv1a_offset_basis} {
+  auto add = [this](std::uint64_t value) {
+    hash = fnv1a(std::string_view{reinterpret_cast<const char*>(&value), sizeof(value)}, hash);
+  };
+  add(static_cast<std::uint64_t>(stride));
+  for (const auto& attribute : attributes) {
+    add(attribute.location);
+    add(static_cast<std::uint64_t>(attribute.components));
+    add(attribute.type);
+    add(static_cast<std::uint64_t>(attribute.format));
+    add(attribute.offset);
+  }
+}
+
+}  // namespace broom
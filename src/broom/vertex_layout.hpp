@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <broom/hash.hpp>
+#include <broom/opengl.hpp>
+
+namespace broom {
+
+// How the shader sees an attribute's values
+enum class AttributeFormat : std::uint8_t {
+  // floats as floats, doubles as doubles and integers as integers, e.g. for ivec4 bone indices
+  native,
+  // integers mapped to [0, 1] or [-1, 1], e.g. for 8 bit colors
+  normalized,
+  // integers converted to floats without scaling
+  converted,
+};
+
+template <GLenum Type, GLint Components = 1, AttributeFormat Format = AttributeFormat::native>
+struct VertexAttributeType {
+  static constexpr GLenum type = Type;
+  static constexpr GLint components = Components;
+  static constexpr AttributeFormat format = Format;
+};
+
+// GL type, component count and default format of a vertex member type, specialize it for further types
+template <typename T>
+struct VertexAttributeTraits;
+
+template <>
+struct VertexAttributeTraits<GLfloat> : VertexAttributeType<GL_FLOAT> {};
+template <>
+struct VertexAttributeTraits<GLdouble> : VertexAttributeType<GL_DOUBLE> {};
+template <>
+struct VertexAttributeTraits<GLbyte> : VertexAttributeType<GL_BYTE> {};
+template <>
+struct VertexAttributeTraits<GLubyte> : VertexAttributeType<GL_UNSIGNED_BYTE> {};
+template <>
+struct VertexAttributeTraits<GLshort> : VertexAttributeType<GL_SHORT> {};
+template <>
+struct VertexAttributeTraits<GLushort> : VertexAttributeType<GL_UNSIGNED_SHORT> {};
+template <>
+struct VertexAttributeTraits<GLint> : VertexAttributeType<GL_INT> {};
+template <>
+struct VertexAttributeTraits<GLuint> : VertexAttributeType<GL_UNSIGNED_INT> {};
+
+template <glm::length_t L, typename T, glm::qualifier Q>
+struct VertexAttributeTraits<glm::vec<L, T, Q>>
+    : VertexAttributeType<VertexAttributeTraits<T>::type, L, VertexAttributeTraits<T>::format> {
+  static_assert(sizeof(glm::vec<L, T, Q>) == L * sizeof(T), "Aligned glm types are not tightly packed");
+};
+
+template <typename T>
+struct MemberPointer;
+
+template <typename C, typename M>
+struct MemberPointer<M C::*> {
+  using class_type = C;
+  using member_type = M;
+};
+
+// offsetof for a member pointer, measured on a value-initialized vertex once on first use
+template <auto Member>
+std::size_t member_offset() {
+  using Class = typename MemberPointer<decltype(Member)>::class_type;
+  static_assert(std::is_standard_layout_v<Class>, "Vertex structs need a standard layout to have offsets");
+  static_assert(std::is_default_constructible_v<Class>, "Vertex structs need to be default constructible");
+  static const Class object{};
+  return reinterpret_cast<const unsigned char*>(&(object.*Member)) - reinterpret_cast<const unsigned char*>(&object);
+}
+
+struct VertexAttributeFormat {
+  GLuint location;
+  GLint components;
+  GLenum type;
+  AttributeFormat format;
+  GLuint offset;
+};
+
+// The attributes read from one vertex buffer binding, as a value that can be compared and hashed.
+struct VertexFormat {
+  VertexFormat(const std::vector<VertexAttributeFormat>& attributes, GLsizei stride);
+
+  std::vector<VertexAttributeFormat> attributes;
+  GLsizei stride;
+  // equal for formats with equal attributes and stride
+  std::uint64_t hash;
+};
+
+// An attribute at a shader location read from a vertex member, e.g. VertexAttribute<0, &Vertex::position>.
+// Type and component count follow from the member type, the format defaults to the type's.
+template <GLuint Location, auto Member, AttributeFormat Format = VertexAttributeTraits<
+                                            typename MemberPointer<decltype(Member)>::member_type>::format>
+struct VertexAttribute {
+  using vertex_type = typename MemberPointer<decltype(Member)>::class_type;
+  using member_type = typename MemberPointer<decltype(Member)>::member_type;
+  using traits = VertexAttributeTraits<member_type>;
+
+  static_assert(Format == AttributeFormat::native ||
+                    (traits::type != GL_FLOAT && traits::type != GL_HALF_FLOAT && traits::type != GL_DOUBLE),
+                "Only integer attributes can be normalized or converted");
+  static_assert(Format != AttributeFormat::native ||
+                    (traits::type != GL_INT_2_10_10_10_REV && traits::type != GL_UNSIGNED_INT_2_10_10_10_REV),
+                "Packed attributes have to be normalized or converted");
+
+  static VertexAttributeFormat description() {
+    return VertexAttributeFormat{Location, traits::components, traits::type, Format,
+                                 static_cast<GLuint>(member_offset<Member>())};
+  }
+};
+
+// The attributes of one vertex struct, configures a vertex array binding in one call:
+//
+//   using Layout = VertexLayout<VertexAttribute<0, &Vertex::position>, VertexAttribute<1, &Vertex::uv>>;
+//   vertex_array.set_vertex_buffer(0, buffer, Layout::format());
+template <typename... Attributes>
+struct VertexLayout {
+  static_assert(sizeof...(Attributes) > 0, "Vertex layouts need at least one attribute");
+  using vertex_type = std::tuple_element_t<0, std::tuple<typename Attributes::vertex_type...>>;
+  static_assert((std::is_same_v<vertex_type, typename Attributes::vertex_type> && ...),
+                "All attributes of a layout are members of the same vertex struct");
+
+  static constexpr GLsizei stride = sizeof(vertex_type);
+
+  static const VertexFormat& format() {
+    static const VertexFormat format{{Attributes::description()...}, stride};
+    return format;
+  }
+};
+
+}  // namespace broom